@@ -0,0 +1,84 @@
+#ifndef ANALOG_BLOCK_H
+#define ANALOG_BLOCK_H
+
+#include <stdint.h>
+#include "BlockRing.h"
+
+// One block of timer-paced samples for the three analog inputs
+struct AnalogBlock {
+    static const uint8_t LENGTH = 16;
+
+    uint16_t breath[LENGTH];
+    uint16_t pinch[LENGTH];
+    uint16_t expression[LENGTH];
+    uint32_t timestamp; // micros() at the last sample of the block
+    uint32_t cycles;    // ARM_DWT_CYCCNT at the same moment, for latency measurement
+
+    // Mean of one input over the block
+    static uint16_t average(const uint16_t* samples) {
+        uint32_t sum = 0;
+        for (uint8_t i = 0; i < LENGTH; i++) {
+            sum += samples[i];
+        }
+        return sum / LENGTH;
+    }
+};
+
+// Collects samples of the three inputs into blocks and hands complete
+// blocks to the consumer through a ring. The producer is the sampling
+// interrupt (AnalogSampler) on the Teensy and a mock ADC in host tests.
+// A sample that finds the ring full is dropped and counted, so the
+// consumer only ever sees whole blocks.
+// No Arduino dependencies, so it also compiles on a host.
+class AnalogBlockQueue {
+public:
+    static const uint8_t RING_BLOCKS = 8;
+
+    // Producer side: store one sample of each input. Returns true when the
+    // sample completed a block, which the caller then stamps and publishes
+    // with commit().
+    bool add(uint16_t breath, uint16_t pinch, uint16_t expression) {
+        if (current == nullptr) {
+            current = ring.acquire();
+            if (current == nullptr) {
+                overruns++;
+                return false;
+            }
+            fill = 0;
+        }
+
+        current->breath[fill] = breath;
+        current->pinch[fill] = pinch;
+        current->expression[fill] = expression;
+        return ++fill == AnalogBlock::LENGTH;
+    }
+
+    // Producer side: publish the block completed by add()
+    void commit(uint32_t timestamp, uint32_t cycles) {
+        current->timestamp = timestamp;
+        current->cycles = cycles;
+        ring.commit();
+        current = nullptr;
+    }
+
+    // Consumer side: copies out the oldest completed block, false if none
+    bool pop(AnalogBlock& block) { return ring.pop(block); }
+
+    // Drop pending and partial blocks; only while the producer is stopped
+    void clear() {
+        ring.clear();
+        current = nullptr;
+        fill = 0;
+    }
+
+    // Samples dropped because the consumer fell behind and the ring was full
+    uint32_t getOverruns() const { return overruns; }
+
+private:
+    BlockRing<AnalogBlock, RING_BLOCKS> ring;
+    AnalogBlock* current = nullptr; // block being filled by the producer
+    uint8_t fill = 0;               // samples already in current
+    volatile uint32_t overruns = 0;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef ANALOG_SAMPLER_H
+#define ANALOG_SAMPLER_H
+
+#include <Arduino.h>
+#include "AnalogBlock.h"
+
+// Samples breath, pinch and expression from an IntervalTimer interrupt at a
+// fixed rate and hands complete blocks to loop() through a ring buffer, so
+// acquisition timing no longer depends on what the main loop is doing.
+class AnalogSampler {
+public:
+    AnalogSampler(uint8_t breathPin, uint8_t pinchPin, uint8_t expressionPin);
+
+    bool begin(uint32_t sampleRateHz);
+    void end();
+
+    bool setSampleRate(uint32_t sampleRateHz);
+    uint32_t getSampleRate() const { return sampleRate; }
+
+    // Copies out the oldest completed block, returns false if none is ready
+    bool readBlock(AnalogBlock& block) { return blocks.pop(block); }
+
+    // Samples dropped because loop() fell behind and the ring was full
+    uint32_t getOverruns() const { return blocks.getOverruns(); }
+
+    static const uint32_t MIN_SAMPLE_RATE = 1000;
+    static const uint32_t MAX_SAMPLE_RATE = 10000;
+
+private:
+    static void timerISR();
+    static AnalogSampler* instance;
+
+    void sample();
+
+    uint8_t breathPin;
+    uint8_t pinchPin;
+    uint8_t expressionPin;
+
+    uint32_t sampleRate;
+    bool running;
+
+    AnalogBlockQueue blocks;
+
+    IntervalTimer timer;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef ASYNC_I2C_H
+#define ASYNC_I2C_H
+
+#include <stdint.h>
+
+// Command words in LPI2C MTDR layout: command in bits 10:8, data in 7:0
+const uint16_t I2C_CMD_TRANSMIT = 0x000;
+const uint16_t I2C_CMD_RECEIVE = 0x100;  // data = byte count - 1
+const uint16_t I2C_CMD_STOP = 0x200;
+const uint16_t I2C_CMD_START = 0x400;    // data = address << 1 | read
+
+// Port status flags
+const uint32_t I2C_STATUS_STOP = 1 << 0;       // STOP condition sent
+const uint32_t I2C_STATUS_NAK = 1 << 1;
+const uint32_t I2C_STATUS_ARB_LOST = 1 << 2;
+const uint32_t I2C_STATUS_FIFO_ERROR = 1 << 3;
+const uint32_t I2C_STATUS_PIN_LOW = 1 << 4;    // SDA/SCL held low too long
+const uint32_t I2C_STATUS_ERRORS = I2C_STATUS_NAK | I2C_STATUS_ARB_LOST |
+                                   I2C_STATUS_FIFO_ERROR | I2C_STATUS_PIN_LOW;
+
+// Register-level access to one I2C master. The transfer state machine only
+// talks to this interface, so it can be driven by a fake bus off-target.
+class I2CPort {
+public:
+    virtual ~I2CPort() {}
+
+    virtual void attach(void (*isr)()) = 0;
+    virtual uint8_t commandSpace() = 0;          // free command FIFO slots
+    virtual void pushCommand(uint16_t command) = 0;
+    virtual bool popData(uint8_t& data) = 0;     // false when RX FIFO is empty
+    virtual uint32_t status() = 0;
+    virtual void clearStatus(uint32_t flags) = 0;
+    virtual void enableInterrupts(bool enabled, bool wantCommandSpace) = 0;
+    virtual void abort() = 0;                    // flush FIFOs, release the bus
+};
+
+enum class I2CState {
+    IDLE,
+    BUSY,
+    DONE,
+    FAILED
+};
+
+enum class I2CError {
+    NONE,
+    NAK,
+    ARBITRATION_LOST,
+    FIFO_ERROR,
+    PIN_LOW_TIMEOUT,
+    TIMEOUT
+};
+
+// Non-blocking register read: START, register address, repeated START,
+// read N bytes, STOP. Commands are fed and data drained from the port
+// interrupt; poll() from loop() enforces the timeout and reports the result.
+class AsyncI2C {
+public:
+    explicit AsyncI2C(I2CPort& port);
+
+    void begin();
+
+    bool startRead(uint8_t address, uint8_t reg, uint8_t* buffer, uint8_t length,
+                   uint32_t nowUs, uint32_t timeoutUs);
+
+    // Call from the port ISR
+    void service();
+
+    // Call from loop(); returns BUSY until the transfer finishes or times out
+    I2CState poll(uint32_t nowUs);
+
+    // Return a DONE/FAILED transfer to IDLE so the next one can start. Only
+    // a result the last poll() returned is acknowledged: a transfer that
+    // finished after that poll stays DONE/FAILED for the next one.
+    void acknowledge();
+
+    bool isIdle() const { return state == I2CState::IDLE; }
+    I2CError getLastError() const { return lastError; }
+    uint32_t getErrorCount() const { return errorCount; }
+
+private:
+    static const uint8_t MAX_COMMANDS = 5;
+
+    static void portISR();
+    static AsyncI2C* instance;
+
+    void fail(I2CError error);
+
+    I2CPort& port;
+
+    uint16_t commands[MAX_COMMANDS];
+    uint8_t commandCount;
+    volatile uint8_t commandIndex;
+
+    uint8_t* buffer;
+    uint8_t length;
+    volatile uint8_t received;
+
+    volatile I2CState state;
+    I2CState reported; // what the last poll() returned
+    volatile I2CError lastError;
+    uint32_t errorCount;
+
+    uint32_t startTime;
+    uint32_t timeout;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef BLOCK_RING_H
+#define BLOCK_RING_H
+
+#include <stdint.h>
+
+// Single-producer/single-consumer ring of fixed-size items, used to hand
+// data from an interrupt to loop(). The producer fills the slot returned by
+// acquire() in place and publishes it with commit(); the consumer copies
+// items out with pop(). One slot is kept free, so it holds N - 1 items.
+// No Arduino dependencies, so it also compiles on a host.
+template <typename T, uint8_t N>
+class BlockRing {
+public:
+    // Producer side: slot to fill next, or nullptr when the ring is full
+    T* acquire() {
+        uint8_t next = advance(head);
+        if (next == tail) {
+            return nullptr;
+        }
+        return &items[head];
+    }
+
+    // Producer side: publish the slot returned by acquire()
+    void commit() {
+        barrier();
+        head = advance(head);
+    }
+
+    // Producer side: copy an item in, returns false when the ring is full
+    bool push(const T& item) {
+        T* slot = acquire();
+        if (slot == nullptr) {
+            return false;
+        }
+        *slot = item;
+        commit();
+        return true;
+    }
+
+    // Consumer side: copy out the oldest item, returns false when empty
+    bool pop(T& out) {
+        if (tail == head) {
+            return false;
+        }
+        barrier();
+        out = items[tail];
+        barrier();
+        tail = advance(tail);
+        return true;
+    }
+
+    // Consumer side: drop everything pending
+    void clear() { tail = head; }
+
+    bool empty() const { return tail == head; }
+    uint8_t size() const { return (uint8_t)((head + N - tail) % N); }
+    static uint8_t capacity() { return N - 1; }
+
+private:
+    static uint8_t advance(uint8_t index) { return (uint8_t)((index + 1) % N); }
+    static void barrier() { __asm__ __volatile__("" ::: "memory"); }
+
+    T items[N];
+    volatile uint8_t head = 0; // next slot the producer fills
+    volatile uint8_t tail = 0; // next slot the consumer reads
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define BUTTON_HANDLER_H
 
 #include <Arduino.h>
+#include "BlockRing.h"
 //#include <functional>
 
 const int upButtonPin = 4;
@@ -9,26 +10,55 @@ const int downButtonPin = 2;
 const int leftButtonPin = 3; 
 const int rightButtonPin = 5;
 
+// One raw edge seen by a pin interrupt
+struct ButtonEvent {
+  uint8_t button;  // handler index, in construction order
+  bool pressed;    // pin level after the edge, pulled up so LOW is pressed
+  uint32_t time;   // millis() at the edge
+};
+
+// Pin-change interrupts queue raw edges; dispatch() drains them later and
+// runs debouncing and hold-repeat from the edge timestamps, so the menu
+// callbacks never run inside the input interrupt and nothing polls the pins.
+// All four button pins share one GPIO interrupt on Teensy 4, so the pin
+// handlers never preempt each other and the ring keeps a single producer.
 class ButtonHandler {
 
   public:
+    static const uint8_t MAX_BUTTONS = 4;
+
     ButtonHandler(int pin, void (*callback)());
-    void update();
     bool getState();
     bool isHeld(); // Check if button is currently held
     unsigned long getHoldDuration(); // Get how long button has been held
 
+    // Attach the pin interrupts of all constructed buttons
+    static void begin();
+
+    // Consumer side: apply queued edges, then run press and repeat callbacks
+    static void dispatch();
+
   private:
+    void edge(bool pressed, uint32_t time);
+    void update(uint32_t now);
+    void resync(uint32_t now); // Read the pin after lost events
+
+    template <uint8_t Index> static void pinChanged();
+
     int m_pin;
 
-    int buttonState = LOW;
-    int lastButtonState = LOW;
-    unsigned long lastDebounceTime = 0;
-    unsigned long buttonPressTime = 0; // Time when button was first pressed
-    bool buttonIsHeld = false;
+    bool rawPressed = false; // Level after the latest edge
+    uint32_t lastEdgeTime = 0;
+    bool buttonIsHeld = false; // Debounced state
+    unsigned long buttonPressTime = 0; // Time of the edge that pressed the button
     unsigned long lastRepeatTime = 0; // Time of last repeat action
 
     void (*m_callback)();
+
+    static ButtonHandler* handlers[MAX_BUTTONS];
+    static uint8_t handlerCount;
+    static BlockRing<ButtonEvent, 64> events;
+    static volatile bool eventsLost; // Ring was full, edges were dropped
 };
 
 #endif
\ No newline at end of file
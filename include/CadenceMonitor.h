@@ -0,0 +1,49 @@
+#ifndef CADENCE_MONITOR_H
+#define CADENCE_MONITOR_H
+
+#include <stdint.h>
+#include "SeqLock.h"
+
+// Timing of a periodic task as seen from inside it
+struct CadenceStats {
+    uint32_t ticks;
+    uint32_t minIntervalUs; // start to start
+    uint32_t maxIntervalUs;
+    uint32_t lateTicks;     // started more than the tolerance off the period
+    uint32_t maxRunUs;
+};
+
+// Records when a periodic task starts and how long it runs, so the loop
+// can check that its cadence holds while other work is going on. record()
+// is called from the task (an interrupt); the loop reads a coherent copy
+// through a SeqLock and asks for resets through a flag, so neither side
+// ever waits for the other.
+// No Arduino dependencies, so it also compiles on a host.
+class CadenceMonitor {
+public:
+    CadenceMonitor(uint32_t periodUs, uint32_t toleranceUs);
+
+    // Writer side, once per run
+    void record(uint32_t startUs, uint32_t endUs);
+
+    // Reader side
+    CadenceStats getStats() const { return published.read(); }
+    void requestReset() { resetPending = true; }
+
+    uint32_t getPeriod() const { return period; }
+
+private:
+    void clear();
+
+    const uint32_t period;
+    const uint32_t tolerance;
+
+    CadenceStats stats;
+    uint32_t lastStart;
+    bool started;
+    volatile bool resetPending;
+
+    SeqLock<CadenceStats> published;
+};
+
+#endif
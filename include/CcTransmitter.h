@@ -0,0 +1,84 @@
+#ifndef CC_TRANSMITTER_H
+#define CC_TRANSMITTER_H
+
+#include <stdint.h>
+#include "MidiSink.h"
+
+enum class MidiPort : uint8_t {
+    USB,
+    DIN,
+    COUNT
+};
+
+// Control change output that remembers the last value sent per port,
+// channel and controller and only passes on real changes. A change that
+// reverses direction must exceed the hysteresis band, which stops a value
+// sitting on a quantisation edge from flickering by one step. An optional
+// refresh resends every value periodically for receivers that join late.
+// 14-bit controllers, NRPNs and pitch bend are tracked at full resolution with their
+// own band, so they only go out when the 14-bit value really moves.
+// No Arduino dependencies, so it also compiles on a host.
+class CcTransmitter {
+public:
+    CcTransmitter(MidiSink& usb, MidiSink& din);
+
+    // channel is 1-16. Each returns true if the message went out.
+    bool send(MidiPort port, uint8_t channel, uint8_t control, uint8_t value);
+    bool sendHighRes(MidiPort port, uint8_t channel, uint8_t control, uint16_t value); // control 0-31
+    bool sendNrpn(MidiPort port, uint8_t channel, uint8_t parameter, uint16_t value);
+    bool sendPitchBend(MidiPort port, uint8_t channel, uint16_t value); // 14-bit, 8192 = center
+    bool sendPressure(MidiPort port, uint8_t channel, uint8_t value);
+
+    // Call once per loop; starts a refresh round when the interval has passed
+    void update(uint32_t nowMs);
+
+    void setHysteresis(uint8_t steps) { hysteresis = steps; }
+    void setHighResHysteresis(uint16_t steps) { highResHysteresis = steps; }
+    void setRefreshInterval(uint32_t ms) { refreshInterval = ms; } // 0 = off
+
+    // Forget everything sent so the next value of every controller goes out
+    void invalidate();
+
+    uint32_t getRequested(MidiPort port) const { return requested[(uint8_t)port]; }
+    uint32_t getSent(MidiPort port) const { return sent[(uint8_t)port]; }
+    uint32_t getSuppressed(MidiPort port) const { return requested[(uint8_t)port] - sent[(uint8_t)port]; }
+    void resetCounters();
+
+private:
+    static const uint8_t PORTS = (uint8_t)MidiPort::COUNT;
+    static const uint8_t CHANNELS = 16;
+    static const uint8_t CONTROLS = 128;
+    static const uint8_t HIGH_RES_CONTROLS = 32;
+
+    static const uint8_t FLAG_VALID = 1 << 0;
+    static const uint8_t FLAG_RISING = 1 << 1;  // direction of the last change,
+    static const uint8_t FLAG_FALLING = 1 << 2; // neither until one is seen
+
+    struct Entry {
+        uint16_t value;
+        uint8_t flags;
+        uint8_t round; // refresh round the value was last sent in
+    };
+
+    // Delta and hysteresis check; records the value if it should go out
+    bool accept(Entry& entry, uint16_t value, uint16_t maxValue, uint16_t band, uint16_t rest = 0);
+    static void clear(Entry* entries, uint16_t count, uint8_t round);
+
+    MidiSink* sinks[PORTS];
+    Entry controls[PORTS][CHANNELS][CONTROLS];
+    Entry highRes[PORTS][CHANNELS][HIGH_RES_CONTROLS];
+    Entry nrpns[PORTS][CHANNELS][CONTROLS];
+    Entry pitchBends[PORTS][CHANNELS];
+    Entry pressures[PORTS][CHANNELS];
+
+    uint8_t hysteresis;
+    uint16_t highResHysteresis;
+    uint32_t refreshInterval;
+    uint32_t lastRefresh;
+    uint8_t refreshRound;
+
+    uint32_t requested[PORTS];
+    uint32_t sent[PORTS];
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef CIC_DECIMATOR_H
+#define CIC_DECIMATOR_H
+
+#include <stdint.h>
+
+// Third-order CIC decimator (R = 16) followed by a 3-tap droop compensator.
+// Turns a block of 16 12-bit ADC samples into one 16-bit output sample:
+// the oversampling adds two bits of resolution and the compensator keeps
+// the passband flat with only one output sample of extra delay.
+class CicDecimator {
+public:
+    static const uint8_t RATIO = 16;
+    static const uint8_t ORDER = 3;
+    static const uint16_t FULL_SCALE = 4095 * 16; // output for a full-scale input
+
+    CicDecimator();
+
+    // Settle all stages on a constant input so there is no start-up ramp
+    void reset(uint16_t value);
+
+    // Consumes exactly RATIO samples and returns the decimated value
+    uint16_t process(const uint16_t* samples);
+
+private:
+    // Register growth is 12 + ORDER * log2(RATIO) = 24 bits, so wrapping
+    // 32-bit arithmetic is exact for the integrator/comb pairs.
+    uint32_t integrator[ORDER];
+    uint32_t comb[ORDER];
+
+    int32_t history[2]; // previous CIC outputs for the compensator
+};
+
+#endif
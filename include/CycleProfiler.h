@@ -0,0 +1,65 @@
+#ifndef CYCLE_PROFILER_H
+#define CYCLE_PROFILER_H
+
+#include <stdint.h>
+
+// Figures for one profiled section, all in clock cycles
+struct SectionProfile {
+    const char* name;
+    uint32_t runs;
+    uint32_t lastCycles;
+    uint32_t meanCycles;  // over the last completed window
+    uint32_t worstCycles; // over the last completed window
+    uint32_t peakCycles;  // since the last reset
+    uint32_t overruns;    // runs longer than the section's budget
+};
+
+// Measures how many cycles named code sections take. Each section keeps
+// its own rolling window: mean and worst are published when a window of
+// the given length (in cycles) has passed, so they follow the current
+// load, while the peak and the overrun count hold until reset().
+// A section must be recorded from one context only (an interrupt or the
+// loop); readers in another context copy the figures with that context
+// held off. The clock is injected (on Teensy the DWT cycle counter).
+// No Arduino dependencies, so it also compiles on a host.
+class CycleProfiler {
+public:
+    typedef uint32_t (*ClockFunction)(); // cycles, free running
+
+    static const uint8_t MAX_SECTIONS = 12;
+    static const uint8_t NO_SECTION = 0xFF;
+
+    CycleProfiler(ClockFunction clock, uint32_t windowCycles);
+
+    // budgetCycles 0 means no overrun counting. Returns the section index,
+    // or NO_SECTION when the table is full.
+    uint8_t addSection(const char* name, uint32_t budgetCycles = 0);
+
+    // start() returns the clock, stop() records the cycles since then
+    uint32_t start() const { return clock(); }
+    void stop(uint8_t section, uint32_t startCycles);
+    void record(uint8_t section, uint32_t cycles);
+
+    uint8_t getSectionCount() const { return sectionCount; }
+    SectionProfile getProfile(uint8_t section) const;
+    void reset();
+
+private:
+    struct Section {
+        SectionProfile profile;
+        uint32_t budget;
+        uint32_t windowStart;
+        uint32_t windowRuns;
+        uint64_t windowTotal;
+        uint32_t windowWorst;
+    };
+
+    void clear(Section& section, uint32_t now);
+
+    ClockFunction clock;
+    const uint32_t window;
+    Section sections[MAX_SECTIONS];
+    uint8_t sectionCount;
+};
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef DIN_SCHEDULER_H
+#define DIN_SCHEDULER_H
+
+#include <stdint.h>
+#include "MidiSink.h"
+
+// Bandwidth-budgeted transmit queue for a 31250 baud DIN MIDI port.
+// Messages wait in a small slot table instead of the UART buffer:
+// a newer value for the same destination (channel + controller, or
+// channel for pitch bend and pressure) replaces the one still waiting,
+// and service() releases them highest priority first at no more than the
+// wire rate. The UART only ever holds a couple of messages, so latency
+// stays bounded and enqueue never blocks.
+// Output uses running status: a message with the same status byte as the
+// previous one is sent without it, and within a priority the scheduler
+// prefers messages that continue the current status, so a burst of CCs
+// on one channel costs 2 bytes each instead of 3.
+// 14-bit controllers and NRPNs wait as one slot and go out as one unbroken
+// group, so their MSB/LSB and parameter select can't be reordered.
+// No Arduino dependencies, so it also compiles on a host.
+class DinScheduler : public MidiSink {
+public:
+    typedef int (*SpaceFunction)();                               // free TX buffer bytes
+    typedef void (*WriteFunction)(const uint8_t* data, uint8_t length);
+
+    static const uint32_t WIRE_BYTES_PER_SECOND = 3125; // 31250 baud, 10 bits per byte
+    static const uint8_t PRIORITY_HIGHEST = 0;
+    static const uint8_t PRIORITY_LOWEST = 255;
+
+    DinScheduler(SpaceFunction space, WriteFunction write);
+
+    // Queue a channel message; returns false if it was dropped
+    bool enqueue(uint8_t status, uint8_t data1, uint8_t data2, uint8_t priority);
+
+    // MidiSink: queue controller messages at the controller's priority.
+    // NRPNs use the priority of the controller with the same number;
+    // pitch bend and pressure go out at the highest priority.
+    void controlChange(uint8_t control, uint8_t value, uint8_t channel) override;
+    void highResControl(uint8_t control, uint16_t value, uint8_t channel) override;
+    void nrpn(uint16_t parameter, uint16_t value, uint8_t channel) override;
+    void pitchBend(uint16_t value, uint8_t channel) override;
+    void channelPressure(uint8_t value, uint8_t channel) override;
+
+    // Priority used for one controller number
+    void setControlPriority(uint8_t control, uint8_t priority) { controlPriority[control & 0x7F] = priority; }
+    void resetControlPriorities();
+
+    // Call often from loop(): writes what the budget and UART allow
+    void service(uint32_t nowUs);
+
+    // Send the next status byte and NRPN parameter select in full, e.g.
+    // after something else wrote to the port
+    void resetRunningStatus();
+
+    uint8_t pending() const;
+    uint32_t getReplaced() const { return replaced; }    // stale values overwritten
+    uint32_t getDropped() const { return dropped; }      // no slot available
+    uint32_t getWorstLatencyUs() const { return worstLatencyUs; }
+    uint32_t getBytesSaved() const { return bytesSaved; } // status bytes omitted
+    void resetStats();
+
+private:
+    static const uint8_t SLOTS = 32;
+    static const uint8_t BURST_BYTES = 6; // two 3-byte messages may sit in the UART
+    static const uint8_t MAX_GROUP_BYTES = 12; // NRPN select + data entry
+    static const uint32_t TOKEN_SCALE = 1000000; // tokens are byte-microseconds
+    // Repeat the status byte at least this often so a receiver that was
+    // plugged in mid-stream picks it up
+    static const uint32_t RUNNING_STATUS_REFRESH_US = 250000;
+    static const uint16_t NO_PARAMETER = 0xFFFF;
+
+    enum Kind : uint8_t {
+        KIND_MESSAGE,   // one channel message: number = data1, value = data2
+        KIND_HIGH_RES,  // number = MSB controller, value = 14 bits
+        KIND_NRPN       // number = parameter, value = 14 bits
+    };
+
+    struct Slot {
+        bool used;
+        Kind kind;
+        uint8_t status;
+        uint16_t number;
+        uint16_t value;
+        uint8_t priority;
+        uint32_t queuedAt; // micros() of the first enqueue of this destination
+        uint32_t stamp;    // MidiSink stamp of the value waiting
+    };
+
+    static uint8_t messageLength(uint8_t status);
+    static bool sameDestination(const Slot& slot, Kind kind, uint8_t status, uint16_t number);
+
+    bool enqueueSlot(Kind kind, uint8_t status, uint16_t number, uint16_t value, uint8_t priority);
+    uint8_t encode(const Slot& slot, uint8_t* out, uint8_t& saved) const;
+    void appendControl(uint8_t*& out, uint8_t status, uint8_t control, uint8_t value,
+                       uint8_t& currentStatus, uint8_t& saved) const;
+
+    SpaceFunction space;
+    WriteFunction write;
+
+    Slot slots[SLOTS];
+    uint8_t controlPriority[128];
+
+    uint32_t tokens;
+    uint32_t lastService;
+    bool started;
+    uint32_t now; // latest service() time, used to stamp enqueued messages
+
+    uint8_t runningStatus; // 0 when the next message must carry its status
+    uint32_t runningStatusSince;
+    uint16_t selectedParameter[16]; // NRPN selected per channel on the wire
+
+    uint32_t replaced;
+    uint32_t dropped;
+    uint32_t worstLatencyUs;
+    uint32_t bytesSaved;
+};
+
+#endif
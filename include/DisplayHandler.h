@@ -7,6 +7,9 @@
 #include <Adafruit_ILI9341.h>
 #include "SensorCache.h"
 #include "UserSettings.h"
+#include "SignalChain.h"
+#include "LatencyHistogram.h"
+#include "CycleProfiler.h"
 #include "logo.h"
 
 // Pin definitions
@@ -26,7 +29,10 @@ enum class MenuState {
 	SUB_MENU,
 	EDIT_MODE,
 	CONFIRM_DIALOG,
-	ABOUT
+	ABOUT,
+	LATENCY,
+	PROFILE, // Hidden: Right on the About screen
+	SENSOR_VALUES // Hidden: Down on the About screen
 };
 
 class DisplayHandler {
@@ -40,6 +46,13 @@ public:
 	void pressLeft();
 	void pressRight();
 
+	// Where the diagnostic screens read and reset their figures
+	typedef LatencySummary (*LatencyReadFunction)(uint8_t port);
+	typedef SectionProfile (*ProfileReadFunction)(uint8_t section);
+	typedef void (*ResetFunction)();
+	void setLatencySource(LatencyReadFunction read, ResetFunction reset);
+	void setProfileSource(ProfileReadFunction read, uint8_t sections, ResetFunction reset);
+
 	private:
 
 	void drawMainMenu();
@@ -47,6 +60,8 @@ public:
 	void drawEditMode();
 	void drawConfirmDialog();
 	void drawAbout();
+	void drawLatency(); // Sensor-to-MIDI latency per port
+	void drawProfile(); // Cycles per profiled section
 	void showLoadingScreen();
 	void drawDiagnosticScreen();
 	void drawSensorValues();
@@ -54,7 +69,16 @@ public:
 	void drawMidiMenu();
 	void redrawEditValue(); // Redraw just the value being edited
 	void drawResponseCurve(); // Draw curve visualization in sensor detail menu
+	SignalChain::Response previewResponse(); // Selected sensor's curve, with the value being edited
+	void drawCurvePoints(); // Control point markers while editing a user curve
+	void redrawCurve(); // Clear the graph and draw the curve again
+	void adjustCurvePoint(int delta);
+	String curveText(int curve); // "4" for presets, "User 1" for user curves
 	void updateCurveSensorIndicator(); // Update live sensor position on curve
+	void updateImuDemand(); // Tell SensorCache which IMU fields the screen shows
+	int getMatrixValue(int item); // Field of the selected matrix slot
+	void setMatrixValue(int item, int value);
+	String matrixValueText(int item, int value);
 
 	// State management
 	void sleep();
@@ -79,7 +103,11 @@ public:
 	float editValueFloat = 0.0;
 	bool editingFloat = false;
 	bool inlineEditMode = false; // True when editing a value inline
-	int pendingResetType = 0; // 0=none, 1=calibration, 2=curves, 3=midi, 4=factory
+	bool pointEditMode = false; // True when moving the points of a user curve
+	int pointSelection = 0;
+	CurvePoints editPoints;
+	SplineCurve previewSpline; // Spline behind previewResponse() for user curves
+	int pendingResetType = 0; // 0=none, 1=calibration, 2=curves, 3=midi, 4=factory, 5=sensors, 6=matrix
 
 	// Previous state for partial updates
 	int prevMainMenuSelection = -1;
@@ -89,23 +117,35 @@ public:
 	float prevEditValueFloat = -1.0;
 	bool needsFullRedraw = true;
 	float prevSensorValue = -1.0; // Previous sensor reading for curve indicator
+	uint8_t screenImuFields = 0; // IMU fields the current full screen needs
 
 	// Timing
 	unsigned long lastActivityTime = 0;
 	unsigned long stateStartTime = 0;
 	unsigned long lastCurveUpdate = 0;
+	unsigned long lastDiagnosticUpdate = 0;
+
+	// Diagnostic sources
+	LatencyReadFunction readLatency = nullptr;
+	ResetFunction resetLatency = nullptr;
+	ProfileReadFunction readProfile = nullptr;
+	ResetFunction resetProfile = nullptr;
+	uint8_t profileSections = 0;
 
 	// Menu items
-	static const int mainMenuCount = 4;
+	static const int mainMenuCount = 5;
 	static const int sensorsSubMenuCount = 6; // 5 sensors + Reset
 	static const int sensorDetailMenuCount = 4; // Calibration, Curve, Floor, Ceiling
-	static const int midiSubMenuCount = 9;
-	static const int deviceSettingsSubMenuCount = 3;
+	static const int midiSubMenuCount = 14; // ..., 5 resolutions + Reset
+	static const int matrixSubMenuCount = UserSettings::MOD_SLOTS + 1; // slots + Reset
+	static const int matrixSlotMenuCount = 7;
+	static const int deviceSettingsSubMenuCount = 4;
 	
 	// Scroll offsets for menus
 	int mainMenuScroll = 0;
 	int subMenuScroll = 0;
 	int thirdMenuScroll = 0;
 	static const int maxVisibleItems = 7; // Max items visible on screen at once
+	static const int pointStep = 5; // User curve point change per press, levels 0-255
 };
 #endif
@@ -0,0 +1,48 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+
+// Summary of one histogram, all times in microseconds
+struct LatencySummary {
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t meanUs;
+    uint32_t p99Us; // upper edge of the bin holding the 99th percentile
+    uint32_t maxUs;
+};
+
+// Log-linear latency histogram: one bin per microsecond below 16 us, then
+// four bins per octave up to about 16 s, so any percentile is reported
+// within 25%. record() is constant time and allocation free, so it can be
+// called from an interrupt; min, max and mean are exact.
+// No Arduino dependencies, so it also compiles on a host.
+class LatencyHistogram {
+public:
+    static const uint8_t LINEAR_BINS = 16;
+    static const uint8_t STEPS_PER_OCTAVE = 4;
+    static const uint8_t OCTAVES = 20;
+    static const uint8_t BINS = LINEAR_BINS + STEPS_PER_OCTAVE * OCTAVES;
+
+    LatencyHistogram();
+
+    void record(uint32_t us);
+    void reset();
+
+    LatencySummary summarize() const;
+
+    // Upper edge of the bin holding the given fraction of samples, in 1/1000
+    uint32_t percentile(uint16_t perMille) const;
+
+    static uint8_t binOf(uint32_t us);
+    static uint32_t binUpper(uint8_t bin);
+
+private:
+    uint32_t bins[BINS];
+    uint32_t count;
+    uint64_t total;
+    uint32_t minimum;
+    uint32_t maximum;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef LPI2C_PORT_H
+#define LPI2C_PORT_H
+
+#include "AsyncI2C.h"
+
+// LPI2C1 (pins 18/19, the Wire port). Relies on Wire.begin() for pin mux
+// and clock setup; Wire's own blocking calls must not overlap a transfer.
+class Lpi2cPort : public I2CPort {
+public:
+    void attach(void (*isr)()) override;
+    uint8_t commandSpace() override;
+    void pushCommand(uint16_t command) override;
+    bool popData(uint8_t& data) override;
+    uint32_t status() override;
+    void clearStatus(uint32_t flags) override;
+    void enableInterrupts(bool enabled, bool wantCommandSpace) override;
+    void abort() override;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef MIDI_SINK_H
+#define MIDI_SINK_H
+
+#include <stdint.h>
+
+// Controller output of one MIDI port. Channels are 1-16, argument order
+// follows the MIDI library (number, value, channel).
+// Messages carry the stamp set before them (e.g. the acquisition time of
+// the sensor values), and the handoff function receives it when the
+// message actually goes to the port, for latency measurement.
+class MidiSink {
+public:
+    typedef void (*HandoffFunction)(uint32_t stamp);
+
+    virtual ~MidiSink() {}
+
+    // Stamp for the messages passed from now on
+    void setStamp(uint32_t value) { stamp = value; }
+
+    void setHandoffFunction(HandoffFunction function) { handoff = function; }
+
+    virtual void controlChange(uint8_t control, uint8_t value, uint8_t channel) = 0;
+
+    // 14-bit controller: MSB on control (0-31), LSB on control + 32
+    virtual void highResControl(uint8_t control, uint16_t value, uint8_t channel) = 0;
+
+    // 14-bit value on a non-registered parameter (CC 99/98, then 6/38)
+    virtual void nrpn(uint16_t parameter, uint16_t value, uint8_t channel) = 0;
+
+    // 14-bit bend, 8192 = center
+    virtual void pitchBend(uint16_t value, uint8_t channel) = 0;
+
+    virtual void channelPressure(uint8_t value, uint8_t channel) = 0;
+
+    // A receiver may have lost state this sink relies on (a refresh round
+    // started, or the port reconnected), so send it in full again.
+    // Safe from the interrupt and from loop().
+    virtual void refresh() {}
+
+protected:
+    void handedOff(uint32_t messageStamp) const {
+        if (handoff) {
+            handoff(messageStamp);
+        }
+    }
+
+    uint32_t stamp = 0;
+    HandoffFunction handoff = nullptr;
+};
+
+#endif
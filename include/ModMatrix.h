@@ -0,0 +1,112 @@
+#ifndef MOD_MATRIX_H
+#define MOD_MATRIX_H
+
+#include <stdint.h>
+#include "ResponseMap.h"
+
+// Modulation inputs. The first five are the sensor channels in
+// SensorChannel order; the rest are derived from the IMU.
+enum class ModSource : uint8_t {
+    BREATH,
+    PINCH,
+    EXPRESSION,
+    TILT,   // gyro X, dps
+    NOD,    // gyro Y, dps
+    TWIST,  // gyro Z, 0-1 over 0..250 dps
+    ROLL,   // orientation, 0-1 over -180..180 degrees
+    PITCH,  // orientation, 0-1 over -90..90 degrees
+    YAW,    // orientation, 0-1 over -180..180 degrees
+    COUNT
+};
+
+inline bool isImuSource(ModSource source) {
+    return source >= ModSource::TILT && source < ModSource::COUNT;
+}
+
+enum class ModDestination : uint8_t {
+    NONE,
+    CC,               // 7-bit controller
+    CC_14BIT,         // MSB/LSB pair on number and number + 32 (0-31)
+    NRPN,             // 14-bit NRPN, parameter = number
+    PITCH_BEND,       // bipolar around the center, amount sets the depth
+    CHANNEL_PRESSURE,
+    COUNT
+};
+
+// One source -> destination route with its own response and depth.
+// Packed into 8 bytes so the settings store it as is.
+struct ModSlot {
+    ModSource source = ModSource::BREATH;
+    ModDestination destination = ModDestination::NONE;
+    uint8_t number = 0;   // CC or NRPN parameter, 0-127
+    int8_t amount = 100;  // percent, negative inverts
+    uint8_t curve = 1;    // preset 1-10 or user curve up to CURVE_SETTING_MAX
+    uint8_t floor = 0;    // percent of the input range
+    uint8_t ceiling = 100;
+    uint8_t reserved = 0;
+
+    bool isValid() const {
+        return source < ModSource::COUNT && destination < ModDestination::COUNT &&
+               number <= 127 && amount >= -100 && amount <= 100 &&
+               curve >= 1 && curve <= CURVE_SETTING_MAX && floor <= 100 && ceiling <= 100;
+    }
+};
+
+// One evaluated route, ready to send
+struct ModOutput {
+    ModSource source; // which sensor the value came from, for its timestamp
+    ModDestination destination;
+    uint8_t number;
+    uint16_t value; // 14-bit; pitch bend is centered on 8192
+};
+
+// Evaluates every active route from one array of source values. Each
+// slot's calibration, floor, ceiling and curve are compiled into its own
+// ResponseMap and the amount into a fixed-point gain and offset, so a
+// route costs one table lookup and one multiply-add. Unused slots are
+// kept out of the evaluation loop entirely.
+// No Arduino dependencies, so it also compiles on a host.
+class ModMatrix {
+public:
+    static const uint8_t SLOTS = 9;
+    static const uint16_t PITCH_BEND_CENTER = 8192;
+
+    ModMatrix();
+
+    // Configure one slot; calibration scales its source before the map
+    void setSlot(uint8_t index, const ModSlot& slot, float calibration);
+
+    // Shape of a user curve; takes effect on the next setSlot() that uses it
+    void setUserCurve(uint8_t index, const CurvePoints& points);
+    const ModSlot& getSlot(uint8_t index) const { return slots[index]; }
+
+    // sources holds ModSource::COUNT values; returns the number of outputs
+    uint8_t evaluate(const float* sources, ModOutput* outputs) const;
+
+    // Bit per ModSource used by an active slot
+    uint16_t getSourceMask() const { return sourceMask; }
+
+private:
+    static const int32_t GAIN_ONE = 1 << 14;
+
+    struct Route {
+        uint8_t map;         // slot index
+        ModSource source;
+        ModDestination destination;
+        uint8_t number;
+        int32_t gain;        // Q14, signed
+        int32_t offset;
+    };
+
+    void rebuildRoutes();
+
+    ModSlot slots[SLOTS];
+    ResponseMap maps[SLOTS];
+    CurvePoints userCurves[USER_CURVES];
+
+    Route routes[SLOTS]; // active slots only, in slot order
+    uint8_t routeCount;
+    uint16_t sourceMask;
+};
+
+#endif
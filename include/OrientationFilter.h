@@ -0,0 +1,46 @@
+#ifndef ORIENTATION_FILTER_H
+#define ORIENTATION_FILTER_H
+
+#include <stdint.h>
+
+// Madgwick gradient-descent orientation filter. Fuses gyro rates with the
+// accelerometer (and magnetometer when available) into a unit quaternion,
+// so tilt and nod can be read as angles that hold when the head stops.
+// Single-precision only, which the Cortex-M7 FPU does in hardware.
+class OrientationFilter {
+public:
+    OrientationFilter();
+
+    // Start from the roll and pitch given by gravity, heading zero; the
+    // magnetometer pulls the heading in over the following updates
+    void reset(float ax, float ay, float az);
+
+    // Gyro in deg/s, accel in g, mag in any consistent unit, dt in seconds
+    void update(float gx, float gy, float gz,
+                float ax, float ay, float az,
+                float mx, float my, float mz, float dt);
+    void updateIMU(float gx, float gy, float gz,
+                   float ax, float ay, float az, float dt);
+
+    // Euler angles in degrees
+    float getRoll() const;
+    float getPitch() const;
+    float getYaw() const;
+
+    void setBeta(float value) { beta = value; }
+    float getBeta() const { return beta; }
+
+    float getQ0() const { return q0; }
+    float getQ1() const { return q1; }
+    float getQ2() const { return q2; }
+    float getQ3() const { return q3; }
+
+private:
+    static float invSqrt(float x);
+    void integrate(float qDot0, float qDot1, float qDot2, float qDot3, float dt);
+
+    float beta; // accel/mag correction gain
+    float q0, q1, q2, q3;
+};
+
+#endif
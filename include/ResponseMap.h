@@ -0,0 +1,47 @@
+#ifndef RESPONSE_MAP_H
+#define RESPONSE_MAP_H
+
+#include <stdint.h>
+#include "SplineCurve.h"
+
+// One channel's calibration, floor, ceiling and curve compiled into a
+// lookup table. The table covers the calibrated 0-1 input in 4096 steps,
+// so mapping a sample is a multiply, a clamp and an interpolated lookup
+// instead of branches, a division and possibly a sqrt.
+// No Arduino dependencies, so it also compiles on a host.
+class ResponseMap {
+public:
+    static const uint16_t SIZE = 4096;              // one entry per 12-bit ADC code
+    static const uint16_t OUTPUT_MAX = (1 << 14) - 1; // 14-bit output
+
+    ResponseMap();
+
+    // Rebuild the table; returns false if the parameters were unchanged.
+    // points shapes user curves (USER_CURVE_FIRST and up) and is otherwise unused.
+    bool build(float calibration, int curve, float floor, float ceiling,
+               const CurvePoints* points = nullptr);
+
+    // Uncalibrated input (normalized sensor value, or dps for the gyro)
+    // to a 14-bit output
+    uint16_t map(float input) const;
+
+    // 12-bit calibrated input code to a 14-bit output
+    uint16_t lookup(uint16_t code) const { return table[code < SIZE ? code : SIZE - 1]; }
+
+    // Float reference, the same SignalChain stages the table is built from
+    static float evaluate(float input, int curve, float floor, float ceiling,
+                          const CurvePoints* points = nullptr);
+
+private:
+    uint16_t table[SIZE];
+    float indexScale; // calibration * (SIZE - 1)
+
+    float calibration;
+    int curve;
+    float floor;
+    float ceiling;
+    CurvePoints points;
+    bool built;
+};
+
+#endif
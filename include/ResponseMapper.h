@@ -0,0 +1,42 @@
+#ifndef RESPONSE_MAPPER_H
+#define RESPONSE_MAPPER_H
+
+#include "ModMatrix.h"
+#include "UserSettings.h"
+
+// Keeps the ModMatrix in step with UserSettings. The five sensor channels
+// fill the first slots (CC and resolution pick the destination), the
+// user routes the rest. update() is cheap when nothing changed: it only
+// compares the settings revision.
+// There are two matrices: update() rebuilds the one evaluate() is not
+// using and then switches over, so the control interrupt can keep
+// evaluating while loop() rebuilds tables. update() must not be called
+// from the interrupt, and evaluate() must not be preempted by update().
+class ResponseMapper {
+public:
+    static const uint8_t USER_SLOT_BASE = UserSettings::CHANNELS;
+
+    explicit ResponseMapper(const UserSettings& settings);
+
+    // Rebuild the slots whose settings changed since the last call
+    void update();
+
+    // sources holds ModSource::COUNT values; returns the number of outputs
+    uint8_t evaluate(const float* sources, ModOutput* outputs) const {
+        return matrices[active].evaluate(sources, outputs);
+    }
+
+    const ModMatrix& getMatrix() const { return matrices[active]; }
+
+private:
+    static_assert(UserSettings::CHANNELS + UserSettings::MOD_SLOTS <= ModMatrix::SLOTS,
+                  "ModMatrix has too few slots for the settings");
+
+    const UserSettings& settings;
+    ModMatrix matrices[2];
+    volatile uint8_t active; // matrix evaluate() reads
+    uint32_t revision;
+    bool primed;
+};
+
+#endif
@@ -3,6 +3,83 @@
 
 #include <Arduino.h>
 #include <ICM20948_WE.h>
+#include "AnalogSampler.h"
+#include "CicDecimator.h"
+#include "AsyncI2C.h"
+#include "Lpi2cPort.h"
+#include "OrientationFilter.h"
+#include "SeqLock.h"
+
+enum class ImuMode {
+    POLLED, // blocking register read on every IMU update
+    FIFO,   // drain every accel/gyro frame from the ICM-20948 FIFO in bursts
+    ASYNC   // interrupt-driven register reads that never block loop()
+};
+
+// IMU register groups, combined into acquisition masks
+const uint8_t IMU_ACCEL = 1 << 0;
+const uint8_t IMU_GYRO = 1 << 1;
+const uint8_t IMU_TEMP = 1 << 2;
+const uint8_t IMU_MAG = 1 << 3;
+const uint8_t IMU_ALL = IMU_ACCEL | IMU_GYRO | IMU_TEMP | IMU_MAG;
+
+// Parts of the firmware that ask SensorCache for IMU data
+enum class ImuConsumer : uint8_t {
+    MIDI_OUTPUT,
+    DISPLAY,
+    COUNT
+};
+
+// One accel/gyro frame, timestamped from the IMU output data rate
+struct ImuSample {
+    uint32_t timestamp; // micros()
+    uint32_t cycles;    // ARM_DWT_CYCCNT at the same instant
+    uint8_t fields;     // IMU_ACCEL/IMU_GYRO actually read for this frame
+    float accelX, accelY, accelZ;
+    float gyroX, gyroY, gyroZ;
+};
+
+// Rates used by the activity-adaptive scheduler
+struct AdaptiveSamplingConfig {
+    uint32_t activeRateHz;          // analog sample rate while playing
+    uint32_t idleRateHz;            // analog sample rate when quiet
+    float breathThreshold;          // normalized breath level that counts as activity
+    float motionThreshold;          // gyro rate in dps that counts as activity
+    unsigned long idleTimeout;      // ms without activity before dropping to idle
+    unsigned long idleImuInterval;  // ms between IMU reads when idle
+};
+
+// Every channel from one update(), copied out as a unit so consumers never
+// mix values from different updates
+struct SensorSnapshot {
+    uint32_t timestamp; // micros() when the frame was published
+    uint32_t sequence;  // increments with every published frame
+    uint32_t analogCycles; // ARM_DWT_CYCCNT at the newest analog sample in the frame
+    uint32_t imuCycles;    // ARM_DWT_CYCCNT at the newest accel/gyro sample in the frame
+    
+    uint16_t breathRaw;
+    uint16_t breathHiRes;   // 16-bit, decimated
+    uint16_t breathLevel;   // breathHiRes above the resting baseline, full scale
+    uint16_t expressionRaw;
+    uint16_t pinchRaw;
+    
+    float accelX, accelY, accelZ;
+    float gyroX, gyroY, gyroZ;
+    float magX, magY, magZ;
+    float temperature;
+    float roll, pitch, yaw; // degrees
+    bool imuAvailable;
+    
+    float breathNormalized() const { return breathLevel / (float)CicDecimator::FULL_SCALE; }
+    float expressionNormalized() const { return expressionRaw / 4095.0f; }
+    float pinchNormalized() const { return pinchRaw / 4095.0f; }
+    
+    // IMU-derived modulation sources, 0-1
+    float twistNormalized() const { return gyroZ / 250.0f; }
+    float rollNormalized() const { return (roll + 180.0f) / 360.0f; }
+    float pitchNormalized() const { return (pitch + 90.0f) / 180.0f; }
+    float yawNormalized() const { return (yaw + 180.0f) / 360.0f; }
+};
 
 class SensorCache {
 public:
@@ -12,15 +89,22 @@ public:
     
     void update();
     
+    // Call from loop(): resets the IMU bus after repeated async failures,
+    // which the control interrupt only flags
+    void serviceImuBus();
+    
     uint16_t getBreathRaw() const { return breathRaw; }
+    uint16_t getBreathHiRes() const { return breathHiRes; } // 16-bit, decimated
+    uint16_t getBreathBaseline() const { return (uint16_t)breathBaseline; } // same scale as HiRes
     uint16_t getExpressionRaw() const { return expressionRaw; }
     uint16_t getPinchRaw() const { return pinchRaw; }
     
-    float getBreathNormalized() const { return breathRaw / 4095.0f; }
+    // Breath above the tracked resting pressure, 0-1
+    float getBreathNormalized() const { return breathLevel / (float)CicDecimator::FULL_SCALE; }
     float getExpressionNormalized() const { return expressionRaw / 4095.0f; }
     float getPinchNormalized() const { return pinchRaw / 4095.0f; }
     
-    float getBreathVoltage() const { return (breathRaw / 4095.0f) * 3.3f; }
+    float getBreathVoltage() const { return getBreathNormalized() * 3.3f; }
     float getExpressionVoltage() const { return (expressionRaw / 4095.0f) * 3.3f; }
     float getPinchVoltage() const { return (pinchRaw / 4095.0f) * 3.3f; }
     
@@ -38,10 +122,48 @@ public:
     
     float getTemp() const { return temperature; }
     
+    // Fused orientation in degrees
+    float getRoll() const { return orientation.getRoll(); }
+    float getPitch() const { return orientation.getPitch(); }
+    float getYaw() const { return orientation.getYaw(); }
+    
     bool isIMUAvailable() const { return imuAvailable; }
     
+    // Coherent copy of the frame published by the last update()
+    SensorSnapshot getSnapshot() const { return snapshot.read(); }
+    
+    bool setImuMode(ImuMode mode);
+    ImuMode getImuMode() const { return imuMode; }
+    
+    // Each consumer states the IMU fields it uses; only their union is read
+    void requestImuFields(ImuConsumer consumer, uint8_t fields);
+    uint8_t getImuFields() const { return imuFields; }
+    
+    // Trigger IMU reads from the ICM-20948 data-ready pin instead of millis()
+    bool setImuDataReadyMode(bool enabled);
+    bool getImuDataReadyMode() const { return imuDataReadyMode; }
+    
+    // FIFO resets after the ICM-20948 FIFO wrapped (FIFO mode only)
+    uint32_t getImuFifoOverflows() const { return imuFifoOverflows; }
+    uint32_t getImuBusErrors() const { return imuBus.getErrorCount(); }
+    // Async mode: port resets after repeated failures, and reads skipped
+    // while the bus recovers
+    uint32_t getImuBusResets() const { return imuBusResets; }
+    uint32_t getImuSkippedReads() const { return imuSkippedReads; }
+    
+    // IMU read interval when not in data-ready mode (and while active)
     void setUpdateInterval(unsigned long interval) { updateInterval = interval; }
     
+    // Sample fast while breath or motion is present and slow down after a
+    // quiet period; disabled until configured
+    void setAdaptiveSampling(const AdaptiveSamplingConfig& config);
+    void disableAdaptiveSampling();
+    bool isSamplingActive() const { return samplingActive; }
+    
+    bool setAnalogSampleRate(uint32_t rateHz) { return sampler.setSampleRate(rateHz); }
+    uint32_t getAnalogSampleRate() const { return sampler.getSampleRate(); }
+    uint32_t getAnalogOverruns() const { return sampler.getOverruns(); }
+    
 private:
 
     static const uint8_t BREATH_PIN = 15;
@@ -49,11 +171,55 @@ private:
     static const uint8_t PINCH_PIN = 16;
     
     static const uint8_t ICM20948_ADDR = 0x68;
+    static const uint8_t IMU_INT_PIN = 17; // ICM-20948 INT on the accessory header
+    static const uint8_t IMU_SAMPLE_RATE_DIV = 10; // ODR = 1125 Hz / (1 + div)
+    static const uint32_t IMU_SAMPLE_PERIOD_US = (1 + IMU_SAMPLE_RATE_DIV) * 1000000UL / 1125;
+    
+    // Bank 0 registers used for FIFO bursts
+    static const uint8_t REG_FIFO_COUNTH = 0x70;
+    static const uint8_t REG_FIFO_R_W = 0x72;
+    static const uint16_t IMU_FIFO_SIZE = 512;
+    static const uint8_t IMU_FIFO_FRAME_BYTES = 12; // accel xyz + gyro xyz
+    static const uint8_t IMU_FIFO_BURST_FRAMES = 8; // fits the Wire RX buffer
+    static const unsigned long IMU_AUX_INTERVAL = 100; // ms between mag/temp reads
+    
+    // Accel, gyro, temperature and the AK09916 shadow registers in one block
+    static const uint8_t REG_ACCEL_XOUT_H = 0x2D;
+    static const uint8_t IMU_DATA_BYTES = 20;
+    static const uint8_t IMU_ACCEL_OFFSET = 0;
+    static const uint8_t IMU_GYRO_OFFSET = 6;
+    static const uint8_t IMU_TEMP_OFFSET = 12;
+    static const uint8_t IMU_MAG_OFFSET = 14;
+    static const uint32_t IMU_ASYNC_TIMEOUT_US = 2000;
+    static const uint8_t IMU_ASYNC_MAX_FAILURES = 3;
+    static const unsigned long IMU_ASYNC_RETRY_INTERVAL = 100; // ms without reads after a reset
+    static const uint8_t IMU_SDA_PIN = 18; // Wire, LPI2C1
+    static const uint8_t IMU_SCL_PIN = 19;
+    static const uint32_t IMU_DATA_READY_TIMEOUT_US = 3 * IMU_SAMPLE_PERIOD_US;
+    
+    static const uint32_t ANALOG_SAMPLE_RATE = 8000; // Hz, per channel
+    
+    // Breath baseline tracking: follows the resting pressure only while the
+    // input is within the gate above it, slowly upwards and faster downwards
+    static constexpr float BASELINE_GATE = 0.015f * CicDecimator::FULL_SCALE;
+    static constexpr float BASELINE_RISE_TAU = 4.0f; // seconds
+    static constexpr float BASELINE_FALL_TAU = 0.25f; // seconds
+    
+    static constexpr float ORIENTATION_MAX_DT = 0.1f; // seconds per fusion step
     
     uint16_t breathRaw;
+    uint16_t breathHiRes;
+    uint16_t breathLevel;
+    float breathBaseline;
+    uint32_t analogCycles;
+    uint32_t imuCycles;
     uint16_t expressionRaw;
     uint16_t pinchRaw;
     
+    AnalogSampler sampler;
+    CicDecimator breathDecimator;
+    bool breathPrimed;
+    
     float accelX, accelY, accelZ;
     float gyroX, gyroY, gyroZ;
     float magX, magY, magZ;
@@ -61,12 +227,79 @@ private:
     
     ICM20948_WE imu;
     bool imuAvailable;
+    ImuMode imuMode;
+    
+    // Offsets found by autoOffsets(), in raw LSB, for frames read directly
+    xyzFloat accelOffset;
+    xyzFloat gyroOffset;
+    
+    uint32_t imuFifoOverflows;
+    bool imuFifoRunning; // FIFO collects frames; stopped while nothing is requested
+    unsigned long lastImuAuxRead;
+    
+    Lpi2cPort imuPort;
+    AsyncI2C imuBus;
+    uint8_t imuBuffer[IMU_DATA_BYTES];
+    uint8_t imuAsyncFailures;
+    bool imuAsyncBackoff;
+    unsigned long imuBackoffStart;
+    volatile bool imuBusResetPending; // set by the interrupt, done in loop()
+    uint32_t imuBusResets;
+    uint32_t imuSkippedReads;
+    volatile uint32_t imuReadStart; // micros() when the in-flight read began
+    volatile uint32_t imuReadCycles; // ARM_DWT_CYCCNT at the same instant
+    volatile uint8_t imuReadFields; // fields requested by the in-flight read
+    
+    uint8_t imuDemand[(uint8_t)ImuConsumer::COUNT];
+    volatile uint8_t imuFields;
+    volatile uint8_t imuWindowStart;  // byte offset from REG_ACCEL_XOUT_H
+    volatile uint8_t imuWindowLength;
+    
+    bool imuDataReadyMode;
+    volatile bool imuDataPending;
+    volatile uint32_t imuReadyTime;
+    
+    AdaptiveSamplingConfig adaptive;
+    bool adaptiveEnabled;
+    volatile bool samplingActive; // idle mode ignores data-ready interrupts
+    unsigned long lastActivityTime;
+    
+    SeqLock<SensorSnapshot> snapshot;
+    uint32_t snapshotSequence;
+    
+    OrientationFilter orientation;
+    bool orientationPrimed;
+    uint32_t lastOrientationTime;
+    
+    static SensorCache* instance;
+    static void dataReadyISR();
+    void onImuDataReady();
 
     unsigned long lastUpdate;
     unsigned long updateInterval;
     
     void updateAnalogSensors();
+    void consumeAnalogBlock(const AnalogBlock& block);
+    void trackBreathBaseline();
     void updateIMU();
+    void readImuPolled();
+    void recoverImuBus();
+    void drainImuFifo();
+    void readImuAux();
+    void startImuAsync();
+    bool beginImuRead(uint32_t now, uint32_t cycles);
+    void collectImuAsync();
+    void waitImuIdle();
+    void decodeImuData(const uint8_t* data, uint8_t fields, uint32_t timestamp, uint32_t cycles);
+    static void imuWindow(uint8_t fields, uint8_t& start, uint8_t& length);
+    void decodeAccelGyro(const uint8_t* data, ImuSample& sample) const;
+    void captureImuOffsets();
+    bool readImuRegisters(uint8_t reg, uint8_t* buffer, uint8_t length);
+    void publishImuSample(const ImuSample& sample);
+    void updateOrientation(const ImuSample& sample);
+    void publishSnapshot();
+    void updateActivity(unsigned long now);
+    void setSamplingActive(bool active);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <stdint.h>
+
+// Single-writer sequence lock around a copyable value. The writer bumps the
+// sequence to odd, copies the value in and bumps it back to even; readers
+// copy the value out and retry if the sequence was odd or moved meanwhile.
+// Readers never block the writer, so the writer may run in an interrupt.
+// A reader must not preempt the writer (it would spin), which holds as long
+// as readers run at a lower priority than the writer. A reader that can
+// preempt the writer uses tryRead() instead.
+// No Arduino dependencies, so it also compiles on a host.
+template <typename T>
+class SeqLock {
+public:
+    // Writer side
+    void write(const T& item) {
+        sequence = sequence + 1;
+        barrier();
+        value = item;
+        barrier();
+        sequence = sequence + 1;
+    }
+
+    // Reader side: one coherent copy of the last written value
+    T read() const {
+        T out;
+        uint32_t before;
+        uint32_t after;
+        do {
+            before = sequence;
+            barrier();
+            out = value;
+            barrier();
+            after = sequence;
+        } while ((before & 1) || before != after);
+        return out;
+    }
+
+    // Reader side for a reader that may preempt the writer: one attempt,
+    // false if a write was in progress, and then out is left as it was
+    bool tryRead(T& out) const {
+        uint32_t before = sequence;
+        if (before & 1) {
+            return false;
+        }
+        barrier();
+        T copy = value;
+        barrier();
+        if (sequence != before) {
+            return false;
+        }
+        out = copy;
+        return true;
+    }
+
+    // Number of completed writes
+    uint32_t version() const { return sequence >> 1; }
+
+private:
+    static void barrier() { __asm__ __volatile__("" ::: "memory"); }
+
+    T value = T();
+    volatile uint32_t sequence = 0; // odd while a write is in progress
+};
+
+#endif
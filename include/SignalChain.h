@@ -0,0 +1,204 @@
+#ifndef SIGNAL_CHAIN_H
+#define SIGNAL_CHAIN_H
+
+#include <stdint.h>
+#include <math.h>
+#include <type_traits>
+#include "ModMatrix.h"
+#include "SplineCurve.h"
+
+// Control-path stages as small value types, composed at compile time:
+// source -> calibrate -> clamp -> trim -> curve -> quantize. Every stage is
+// a constexpr call operator, so a Chain of them inlines into straight-line
+// code with no virtual calls or stage loop. The MIDI path reaches these
+// through the ResponseMap tables built from response(); the curve preview
+// calls the same chain directly, so both always agree.
+// Header-only. No Arduino dependencies, so it also compiles on a host.
+namespace SignalChain {
+
+// Source stage: one modulation input read from a sensor frame. Frame is a
+// template parameter so this header does not depend on SensorCache.
+template <ModSource S> struct Source;
+
+template <> struct Source<ModSource::BREATH> {
+    template <typename Frame> static float read(const Frame& f) { return f.breathNormalized(); }
+};
+template <> struct Source<ModSource::PINCH> {
+    template <typename Frame> static float read(const Frame& f) { return f.pinchNormalized(); }
+};
+template <> struct Source<ModSource::EXPRESSION> {
+    template <typename Frame> static float read(const Frame& f) { return f.expressionNormalized(); }
+};
+template <> struct Source<ModSource::TILT> {
+    template <typename Frame> static float read(const Frame& f) { return f.gyroX; }
+};
+template <> struct Source<ModSource::NOD> {
+    template <typename Frame> static float read(const Frame& f) { return f.gyroY; }
+};
+template <> struct Source<ModSource::TWIST> {
+    template <typename Frame> static float read(const Frame& f) { return f.twistNormalized(); }
+};
+template <> struct Source<ModSource::ROLL> {
+    template <typename Frame> static float read(const Frame& f) { return f.rollNormalized(); }
+};
+template <> struct Source<ModSource::PITCH> {
+    template <typename Frame> static float read(const Frame& f) { return f.pitchNormalized(); }
+};
+template <> struct Source<ModSource::YAW> {
+    template <typename Frame> static float read(const Frame& f) { return f.yawNormalized(); }
+};
+
+// Fill sources[ModSource::COUNT], unrolled at compile time
+template <typename Frame, uint8_t I>
+inline typename std::enable_if<(I == (uint8_t)ModSource::COUNT)>::type
+readSources(const Frame&, float*) {}
+
+template <typename Frame, uint8_t I = 0>
+inline typename std::enable_if<(I < (uint8_t)ModSource::COUNT)>::type
+readSources(const Frame& frame, float* sources) {
+    sources[I] = Source<(ModSource)I>::read(frame);
+    readSources<Frame, I + 1>(frame, sources);
+}
+
+// One source picked at run time (e.g. the menu selection)
+template <typename Frame>
+inline float readSource(const Frame& frame, ModSource source) {
+    switch (source) {
+        case ModSource::BREATH: return Source<ModSource::BREATH>::read(frame);
+        case ModSource::PINCH: return Source<ModSource::PINCH>::read(frame);
+        case ModSource::EXPRESSION: return Source<ModSource::EXPRESSION>::read(frame);
+        case ModSource::TILT: return Source<ModSource::TILT>::read(frame);
+        case ModSource::NOD: return Source<ModSource::NOD>::read(frame);
+        case ModSource::TWIST: return Source<ModSource::TWIST>::read(frame);
+        case ModSource::ROLL: return Source<ModSource::ROLL>::read(frame);
+        case ModSource::PITCH: return Source<ModSource::PITCH>::read(frame);
+        case ModSource::YAW: return Source<ModSource::YAW>::read(frame);
+        default: return 0.0f;
+    }
+}
+
+// Scale a raw source into the 0-1 playing range
+struct Calibrate {
+    float gain;
+    constexpr float operator()(float x) const { return x * gain; }
+};
+
+// Constrain to 0-1; NaN goes to 0
+struct Clamp {
+    constexpr float operator()(float x) const { return !(x > 0.0f) ? 0.0f : (x > 1.0f ? 1.0f : x); }
+};
+
+// Map floor..ceiling onto 0-1; below the floor is 0, above the ceiling 1
+struct Trim {
+    float floor;
+    float ceiling;
+    constexpr float operator()(float x) const {
+        return x < floor ? 0.0f :
+               x > ceiling || ceiling <= floor ? 1.0f :
+               (x - floor) / (ceiling - floor);
+    }
+};
+
+// One point of the continuous curve family: the input is raised to
+// exponent, then blended toward an S-curve. blend 0-1 moves from the
+// power curve to smoothstep of it, 1-2 on to smoothstep applied twice.
+// Every setting is monotonic and maps 0 to 0 and 1 to 1.
+struct CurveShape {
+    float exponent;
+    float blend;
+};
+
+// Curve settings 1-10. 1-4 keep their original shapes.
+constexpr uint8_t CURVE_COUNT = 10;
+static_assert(CURVE_COUNT + 1 == USER_CURVE_FIRST, "user curves follow the presets");
+constexpr CurveShape CURVE_SHAPES[CURVE_COUNT] = {
+    {1.0f, 0.0f},         // 1 linear
+    {2.0f, 0.0f},         // 2 concave
+    {0.5f, 0.0f},         // 3 convex
+    {1.0f, 1.0f},         // 4 s-curve
+    {1.5f, 0.0f},         // 5 gentle concave
+    {1.0f / 1.5f, 0.0f},  // 6 gentle convex
+    {3.0f, 0.0f},         // 7 steep concave
+    {1.0f / 3.0f, 0.0f},  // 8 steep convex
+    {1.0f, 0.5f},         // 9 soft s-curve
+    {1.0f, 2.0f}          // 10 hard s-curve
+};
+
+// Response curve for a preset setting 1-10, or a user curve 11-14 drawn
+// by spline. Other settings, or a user curve without a spline, are linear.
+// powf makes this too slow per sample, so the MIDI path only ever runs
+// it while building a ResponseMap table.
+struct Curve {
+    CurveShape shape;
+    const SplineCurve* spline;
+
+    constexpr Curve(int type, const SplineCurve* user = nullptr)
+        : shape(type >= 1 && type <= CURVE_COUNT ? CURVE_SHAPES[type - 1] : CURVE_SHAPES[0])
+        , spline(type >= USER_CURVE_FIRST && type <= CURVE_SETTING_MAX ? user : nullptr) {}
+
+    float operator()(float x) const {
+        if (spline) return (*spline)(x);
+
+        float y = shape.exponent == 1.0f ? x : powf(x, shape.exponent);
+        if (shape.blend <= 0.0f) return y;
+
+        float s = smoothstep(y);
+        if (shape.blend <= 1.0f) return y + (s - y) * shape.blend;
+        return s + (smoothstep(s) - s) * (shape.blend - 1.0f);
+    }
+
+private:
+    static constexpr float smoothstep(float x) { return x * x * (3.0f - 2.0f * x); }
+};
+
+// 0-1 to an unsigned integer of the given width, rounded
+template <uint8_t Bits>
+struct Quantize {
+    static const uint16_t MAX = (1 << Bits) - 1;
+    constexpr uint16_t operator()(float x) const { return (uint16_t)(x * MAX + 0.5f); }
+};
+
+// Stages applied left to right
+template <typename... Stages> class Chain;
+
+template <> class Chain<> {
+public:
+    template <typename T> constexpr T operator()(T x) const { return x; }
+};
+
+template <typename First, typename... Rest>
+class Chain<First, Rest...> {
+public:
+    constexpr Chain(First head, Rest... tail) : first(head), rest(tail...) {}
+
+    template <typename T>
+    auto operator()(T x) const { return rest(first(x)); }
+
+private:
+    First first;
+    Chain<Rest...> rest;
+};
+
+template <typename... Stages>
+constexpr Chain<Stages...> makeChain(Stages... stages) {
+    return Chain<Stages...>(stages...);
+}
+
+// Calibrated input to 0-1 output, as the MIDI path shapes it
+typedef Chain<Clamp, Trim, Curve> Response;
+
+constexpr Response response(int curve, float floor, float ceiling, const SplineCurve* spline = nullptr) {
+    return Response(Clamp(), Trim{floor, ceiling}, Curve(curve, spline));
+}
+
+// Raw source to 0-1 output, calibration included
+typedef Chain<Calibrate, Clamp, Trim, Curve> CalibratedResponse;
+
+constexpr CalibratedResponse response(float calibration, int curve, float floor, float ceiling,
+                                      const SplineCurve* spline = nullptr) {
+    return CalibratedResponse(Calibrate{calibration}, Clamp(), Trim{floor, ceiling}, Curve(curve, spline));
+}
+
+} // namespace SignalChain
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SPLINE_CURVE_H
+#define SPLINE_CURVE_H
+
+#include <stdint.h>
+
+// User-drawn response curves. Each one is a handful of output levels at
+// evenly spaced inputs, selected by curve settings after the presets.
+const uint8_t CURVE_POINTS = 8;
+const uint8_t USER_CURVES = 4;
+const uint8_t USER_CURVE_FIRST = 11; // curve setting of the first user curve
+const uint8_t CURVE_SETTING_MAX = USER_CURVE_FIRST + USER_CURVES - 1;
+
+// Output level 0-255 at input i / (CURVE_POINTS - 1). Stored as is.
+struct CurvePoints {
+    uint8_t level[CURVE_POINTS];
+
+    // Never falling and not flat, as the point editor keeps them. Erased
+    // EEPROM (all 0xFF) fails this.
+    bool isValid() const {
+        for (uint8_t i = 1; i < CURVE_POINTS; i++) {
+            if (level[i] < level[i - 1]) return false;
+        }
+        return level[CURVE_POINTS - 1] > level[0];
+    }
+};
+
+// Monotone cubic (Fritsch-Carlson) through a CurvePoints: smooth, passes
+// through every point and never overshoots between them, so rising points
+// give a rising response. Only evaluated while building a ResponseMap.
+// No Arduino dependencies, so it also compiles on a host.
+class SplineCurve {
+public:
+    SplineCurve(); // straight line
+
+    void setPoints(const CurvePoints& points);
+
+    // 0-1 input to 0-1 output
+    float operator()(float x) const;
+
+    // Points on the straight line from 0 to 255
+    static CurvePoints linear();
+
+private:
+    float level[CURVE_POINTS]; // 0-1
+    float slope[CURVE_POINTS]; // per segment width
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <stdint.h>
+
+// Cooperative periodic scheduler. Each task is released every period and
+// should finish within its deadline of the release; runOnce() starts the
+// released task with the earliest deadline and returns, so short control
+// tasks with tight deadlines go ahead of UI work, which fills the slack.
+// Tasks are never preempted: a task that runs long delays the others, and
+// the statistics show it. A task that falls a whole period behind skips
+// the missed releases instead of running back to back to catch up.
+// The clock is injected, so a virtual clock can drive it off-target.
+// No Arduino dependencies, so it also compiles on a host.
+class TaskScheduler {
+public:
+    typedef uint32_t (*ClockFunction)(); // microseconds, free running
+    typedef void (*TaskFunction)();
+
+    static const uint8_t MAX_TASKS = 8;
+    static const uint8_t NO_TASK = 0xFF;
+
+    struct TaskStats {
+        uint32_t runs;
+        uint32_t deadlineMisses; // finished after release + deadline
+        uint32_t skippedReleases;
+        uint32_t maxLatencyUs;   // release to start
+        uint32_t maxRunUs;
+    };
+
+    explicit TaskScheduler(ClockFunction clock);
+
+    // First release is now. deadlineUs 0 means the period. Returns the task
+    // index, or NO_TASK when the table is full or the period is 0.
+    uint8_t addTask(TaskFunction function, uint32_t periodUs, uint32_t deadlineUs = 0);
+
+    // Run one released task; returns false if none was due
+    bool runOnce();
+
+    // Microseconds until the next release, 0 if one is due
+    uint32_t idleTime() const;
+
+    uint8_t getTaskCount() const { return taskCount; }
+    const TaskStats& getStats(uint8_t task) const { return tasks[task < taskCount ? task : 0].stats; }
+    void resetStats();
+
+private:
+    struct Task {
+        TaskFunction function;
+        uint32_t period;
+        uint32_t deadline; // relative to release
+        uint32_t release;  // absolute time of the current release
+        TaskStats stats;
+    };
+
+    ClockFunction clock;
+    Task tasks[MAX_TASKS];
+    uint8_t taskCount;
+};
+
+#endif
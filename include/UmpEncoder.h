@@ -0,0 +1,50 @@
+#ifndef UMP_ENCODER_H
+#define UMP_ENCODER_H
+
+#include <stdint.h>
+
+// Universal MIDI Packet (MIDI 2.0) encoding for the controller messages
+// PolyGraft sends. Each function writes the packet's 32-bit words to out
+// and returns how many it wrote. Groups are 0-15, channels 1-16 like the
+// rest of the firmware.
+// No Arduino dependencies, so it also compiles on a host.
+class UmpEncoder {
+public:
+    // Message types (top nibble of the first word)
+    static const uint8_t TYPE_UTILITY = 0x0;
+    static const uint8_t TYPE_MIDI1_CHANNEL_VOICE = 0x2;
+    static const uint8_t TYPE_MIDI2_CHANNEL_VOICE = 0x4;
+
+    // Jitter reduction timestamps count in 1/31250 s
+    static const uint32_t JR_TICK_US = 32;
+
+    // Utility: JR Timestamp for the message that follows, from micros()
+    static uint8_t jrTimestamp(uint32_t* out, uint32_t nowUs);
+
+    // MIDI 2.0 Control Change with a 32-bit value
+    static uint8_t controlChange(uint32_t* out, uint8_t group, uint8_t channel,
+                                 uint8_t control, uint32_t value);
+
+    // MIDI 2.0 Assignable Controller (the NRPN replacement), 32-bit value
+    static uint8_t assignableController(uint32_t* out, uint8_t group, uint8_t channel,
+                                        uint16_t parameter, uint32_t value);
+
+    // MIDI 2.0 Pitch Bend, 32-bit with 0x80000000 = center
+    static uint8_t pitchBend(uint32_t* out, uint8_t group, uint8_t channel, uint32_t value);
+
+    // MIDI 2.0 Channel Pressure, 32-bit value
+    static uint8_t channelPressure(uint32_t* out, uint8_t group, uint8_t channel, uint32_t value);
+
+    // MIDI 1.0 Control Change in a UMP, for hosts that negotiated MIDI 1.0
+    static uint8_t midi1ControlChange(uint32_t* out, uint8_t group, uint8_t channel,
+                                      uint8_t control, uint8_t value);
+
+    // Min-center-max upscaling from the MIDI 2.0 spec: 0 stays 0, the
+    // source center maps to the 32-bit center and full scale to 0xFFFFFFFF
+    static uint32_t scaleUp(uint32_t value, uint8_t sourceBits);
+
+    // Plain truncation, the spec's downscaling rule
+    static uint32_t scaleDown(uint32_t value, uint8_t destinationBits) { return value >> (32 - destinationBits); }
+};
+
+#endif
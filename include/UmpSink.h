@@ -0,0 +1,51 @@
+#ifndef UMP_SINK_H
+#define UMP_SINK_H
+
+#include <stdint.h>
+#include "MidiSink.h"
+#include "UsbPacketQueue.h"
+
+// MidiSink that speaks MIDI 2.0: controller values are upscaled to 32 bits
+// and sent as single Control Change or Assignable Controller packets, so
+// 14-bit CCs and NRPNs need no MSB/LSB pairs or parameter selects. With
+// timestamps on, each packet is preceded by a JR Timestamp so the host can
+// undo transport jitter. Packets are queued; flush() passes them from
+// loop() to a writer, which owns the transport.
+// No Arduino dependencies, so it also compiles on a host.
+class UmpSink : public MidiSink {
+public:
+    typedef void (*WriteFunction)(const uint32_t* words, uint8_t count);
+
+    explicit UmpSink(WriteFunction write, uint8_t group = 0);
+
+    void controlChange(uint8_t control, uint8_t value, uint8_t channel) override;
+    void highResControl(uint8_t control, uint16_t value, uint8_t channel) override;
+    void nrpn(uint16_t parameter, uint16_t value, uint8_t channel) override;
+    void pitchBend(uint16_t value, uint8_t channel) override;
+    void channelPressure(uint8_t value, uint8_t channel) override;
+
+    // Time used for the JR Timestamps of the following packets
+    void setTime(uint32_t nowUs) { now = nowUs; }
+    void setTimestamps(bool enabled) { timestamps = enabled; }
+
+    // Write out everything queued; call from loop(), never the interrupt
+    void flush();
+
+    // Messages dropped because the queue was full
+    uint32_t getDropped() const { return queue.getDropped(); }
+    void resetDropped() { queue.resetDropped(); }
+
+private:
+    static const uint8_t MAX_WORDS = 3; // JR Timestamp + 64-bit message
+    static_assert(MAX_WORDS <= UsbPacketQueue::MAX_WORDS, "a message must fit a queue entry");
+
+    void send(uint32_t* words, uint8_t count);
+
+    WriteFunction write;
+    UsbPacketQueue queue;
+    uint8_t group;
+    bool timestamps;
+    uint32_t now;
+};
+
+#endif
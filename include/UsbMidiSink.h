@@ -0,0 +1,51 @@
+#ifndef USB_MIDI_SINK_H
+#define USB_MIDI_SINK_H
+
+#include "MidiSink.h"
+#include "UsbPacketQueue.h"
+
+// MidiSink on the Teensy usbMIDI port. USB has no bandwidth to speak of,
+// so messages are not rate limited; only the NRPN parameter select is
+// skipped when the channel already has that parameter selected.
+// Messages are packed into USB MIDI event packets and queued; flush()
+// writes them out from loop() and hands off their stamps there.
+// No Arduino dependencies, so it also compiles on a host.
+class UsbMidiSink : public MidiSink {
+public:
+    // Writes packets to the endpoint, e.g. with usb_midi_write_packed()
+    typedef void (*WriteFunction)(const uint32_t* words, uint8_t count);
+
+    explicit UsbMidiSink(WriteFunction write);
+
+    void controlChange(uint8_t control, uint8_t value, uint8_t channel) override;
+    void highResControl(uint8_t control, uint16_t value, uint8_t channel) override;
+    void nrpn(uint16_t parameter, uint16_t value, uint8_t channel) override;
+    void pitchBend(uint16_t value, uint8_t channel) override;
+    void channelPressure(uint8_t value, uint8_t channel) override;
+
+    // Write out everything queued; call from loop(), never the interrupt
+    void flush();
+
+    // Select the NRPN parameter again on the next message of every channel
+    void refresh() override { reselect = true; }
+
+    // Messages dropped because the queue was full
+    uint32_t getDropped() const { return queue.getDropped(); }
+    void resetDropped() { queue.resetDropped(); }
+
+    // Cable 0 event packet as usb_midi_write_packed() takes it
+    static uint32_t packet(uint8_t status, uint8_t data1, uint8_t data2, uint8_t channel);
+
+private:
+    static const uint16_t NO_PARAMETER = 0xFFFF;
+
+    void send(const uint32_t* words, uint8_t count);
+    void resetNrpnSelection();
+
+    WriteFunction write;
+    UsbPacketQueue queue;
+    uint16_t selectedParameter[16];
+    volatile bool reselect; // refresh() asked for the selection to be forgotten
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef USB_PACKET_QUEUE_H
+#define USB_PACKET_QUEUE_H
+
+#include <stdint.h>
+#include "BlockRing.h"
+
+// USB MIDI packets on their way from the control interrupt to loop(). The
+// Teensy core's usb_midi_write_packed() waits, calling yield(), while the
+// host has the port open but is not reading it, so it must never run in
+// the interrupt. Sinks push whole messages here, with their stamps, and
+// loop() writes them out. A full queue drops the message and counts it
+// instead of waiting.
+// No Arduino dependencies, so it also compiles on a host.
+class UsbPacketQueue {
+public:
+    static const uint8_t MAX_WORDS = 4; // NRPN select and data entry as MIDI 1.0 packets
+
+    struct Message {
+        uint32_t words[MAX_WORDS];
+        uint8_t count;
+        uint32_t stamp;
+    };
+
+    // Interrupt side; false when the message was dropped
+    bool push(const uint32_t* words, uint8_t count, uint32_t stamp) {
+        Message* slot = ring.acquire();
+        if (slot == nullptr || count > MAX_WORDS) {
+            dropped++;
+            return false;
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            slot->words[i] = words[i];
+        }
+        slot->count = count;
+        slot->stamp = stamp;
+        ring.commit();
+        return true;
+    }
+
+    // loop() side
+    bool pop(Message& out) { return ring.pop(out); }
+
+    uint8_t pending() const { return ring.size(); }
+    uint32_t getDropped() const { return dropped; }
+    void resetDropped() { dropped = 0; }
+
+private:
+    BlockRing<Message, 128> ring; // 127 messages, over 10 ms of every route changing
+    volatile uint32_t dropped = 0;
+};
+
+#endif
@@ -2,6 +2,26 @@
 #define USER_SETTINGS_H
 
 #include <EEPROM.h>
+#include "ModMatrix.h"
+
+// Sensor channels with their own calibration, curve, floor, ceiling,
+// CC and resolution. The order matches the first ModSource entries.
+enum class SensorChannel : uint8_t {
+  BREATH,
+  PINCH,
+  EXPRESSION,
+  TILT,
+  NOD,
+  COUNT
+};
+
+// How a channel's controller value is sent
+enum class CcResolution : uint8_t {
+  STANDARD = 0,  // 7-bit CC
+  HIGH_RES = 1,  // 14-bit CC pair n / n+32 (CC 0-31 only, others fall back to 7-bit)
+  NRPN = 2,      // 14-bit NRPN, parameter number = the channel's CC number
+  COUNT
+};
 
 class UserSettings {
 
@@ -9,78 +29,65 @@ class UserSettings {
     // Initialize and load settings from EEPROM
     void begin();
     
-    // Getters
-    float getCalBreath() const { return calBreath; }
-    float getCalPinch() const { return calPinch; }
-    float getCalExp() const { return calExp; }
-    float getCalTilt() const { return calTilt; }
-    float getCalNod() const { return calNod; }
-    
-    int getBreathCurve() const { return breathCurve; }
-    int getPinchCurve() const { return pinchCurve; }
-    int getExpCurve() const { return expCurve; }
-    int getTiltCurve() const { return tiltCurve; }
-    int getNodCurve() const { return nodCurve; }
-    
-    float getBreathFloor() const { return breathFloor; }
-    float getBreathCeiling() const { return breathCeiling; }
-    float getPinchFloor() const { return pinchFloor; }
-    float getPinchCeiling() const { return pinchCeiling; }
-    float getExpFloor() const { return expFloor; }
-    float getExpCeiling() const { return expCeiling; }
-    float getTiltFloor() const { return tiltFloor; }
-    float getTiltCeiling() const { return tiltCeiling; }
-    float getNodFloor() const { return nodFloor; }
-    float getNodCeiling() const { return nodCeiling; }
-    
-    int getBreathCC() const { return breathCC; }
-    int getPinchCC() const { return pinchCC; }
-    int getExpCC() const { return expCC; }
-    int getTiltCC() const { return tiltCC; }
-    int getNodCC() const { return nodCC; }
+    // Per-channel getters
+    float getCal(SensorChannel channel) const { return cal[(uint8_t)channel]; }
+    int getCurve(SensorChannel channel) const { return curve[(uint8_t)channel]; }
+    float getFloor(SensorChannel channel) const { return floor[(uint8_t)channel]; }
+    float getCeiling(SensorChannel channel) const { return ceiling[(uint8_t)channel]; }
+    int getCC(SensorChannel channel) const { return cc[(uint8_t)channel]; }
+    CcResolution getResolution(SensorChannel channel) const { return (CcResolution)resolution[(uint8_t)channel]; }
     
+    // Getters
     int getScreenSleep() const { return screenSleep; }
     int getDisplayBrightness() const { return displayBrightness; }
     int getMidiChannel() const { return midiChannel; }
     bool getUsbMidiEnabled() const { return usbMidiEnabled; }
     bool getHwMidiEnabled() const { return hwMidiEnabled; }
+    
+    int getActiveSampleRate() const { return activeSampleRate; }
+    int getIdleSampleRate() const { return idleSampleRate; }
+    float getActivityBreathThreshold() const { return activityBreathThreshold; }
+    float getActivityMotionThreshold() const { return activityMotionThreshold; }
+    int getIdleTimeout() const { return idleTimeout; }
+    int getIdleImuInterval() const { return idleImuInterval; }
+    
+    // Modulation matrix routes beyond the five sensor channels
+    const ModSlot& getModSlot(uint8_t slot) const { return modSlots[slot < MOD_SLOTS ? slot : 0]; }
+    
+    // Points of user curve 0 to USER_CURVES - 1 (curve setting USER_CURVE_FIRST + index)
+    const CurvePoints& getUserCurve(uint8_t index) const { return userCurves[index < USER_CURVES ? index : 0]; }
 
-    // Setters that save to EEPROM
-    void setCalBreath(float value);
-    void setCalPinch(float value);
-    void setCalExp(float value);
-    void setCalTilt(float value);
-    void setCalNod(float value);
-    
-    void setBreathCurve(int value);
-    void setPinchCurve(int value);
-    void setExpCurve(int value);
-    void setTiltCurve(int value);
-    void setNodCurve(int value);
-    
-    void setBreathFloor(float value);
-    void setBreathCeiling(float value);
-    void setPinchFloor(float value);
-    void setPinchCeiling(float value);
-    void setExpFloor(float value);
-    void setExpCeiling(float value);
-    void setTiltFloor(float value);
-    void setTiltCeiling(float value);
-    void setNodFloor(float value);
-    void setNodCeiling(float value);
-    
-    void setBreathCC(int value);
-    void setPinchCC(int value);
-    void setExpCC(int value);
-    void setTiltCC(int value);
-    void setNodCC(int value);
+    // Per-channel setters that save to EEPROM
+    void setCal(SensorChannel channel, float value);
+    void setCurve(SensorChannel channel, int value);
+    void setFloor(SensorChannel channel, float value);
+    void setCeiling(SensorChannel channel, float value);
+    void setCC(SensorChannel channel, int value);
+    void setResolution(SensorChannel channel, CcResolution value);
     
+    // Setters that save to EEPROM
     void setScreenSleep(int value);
     void setDisplayBrightness(int value);
     void setMidiChannel(int value);
     void setUsbMidiEnabled(bool enabled);
     void setHwMidiEnabled(bool enabled);
     
+    void setActiveSampleRate(int value);
+    void setIdleSampleRate(int value);
+    void setActivityBreathThreshold(float value);
+    void setActivityMotionThreshold(float value);
+    void setIdleTimeout(int value);
+    void setIdleImuInterval(int value);
+    
+    void setModSlot(uint8_t slot, const ModSlot& value);
+    void resetModSlots();
+    
+    void setUserCurve(uint8_t index, const CurvePoints& points);
+    void resetUserCurves();
+    
+    // Changes whenever any setting does, so derived data can be rebuilt lazily
+    uint32_t getRevision() const { return revision; }
+    
     // Save all settings to EEPROM
     void saveAll();
     
@@ -89,40 +96,19 @@ class UserSettings {
     
     // Public constants
     static constexpr uint32_t FIRMWARE_VERSION = 1; // Increment this to force reset on new uploads
+    static const uint8_t CHANNELS = (uint8_t)SensorChannel::COUNT;
+    static const uint8_t MOD_SLOTS = 4;
 
   private:
-    // Calibration values
-    float calBreath = 1.0;
-    float calPinch = 1.0;
-    float calExp = 1.0;
-    float calTilt = 1.0;
-    float calNod = 1.0;
-    
-    // Curve settings (1-10)
-    uint8_t breathCurve = 5;
-    uint8_t pinchCurve = 5;
-    uint8_t expCurve = 5;
-    uint8_t tiltCurve = 5;
-    uint8_t nodCurve = 5;
-    
-    // Floor and ceiling offsets (0.0-1.0)
-    float breathFloor = 0.0;
-    float breathCeiling = 1.0;
-    float pinchFloor = 0.0;
-    float pinchCeiling = 1.0;
-    float expFloor = 0.0;
-    float expCeiling = 1.0;
-    float tiltFloor = 0.0;
-    float tiltCeiling = 1.0;
-    float nodFloor = 0.0;
-    float nodCeiling = 1.0;
-
-    // MIDI CC assignments
-    uint8_t breathCC = 1;
-    uint8_t pinchCC = 2;
-    uint8_t expCC = 3;
-    uint8_t tiltCC = 4;
-    uint8_t nodCC = 5;
+    uint32_t revision = 0;
+    
+    // Per-channel settings, indexed by SensorChannel
+    float cal[CHANNELS] = {1.0, 1.0, 1.0, 1.0, 1.0};         // Calibration values
+    uint8_t curve[CHANNELS] = {5, 5, 5, 5, 5};               // Curve settings (1-10 presets, 11-14 user curves)
+    float floor[CHANNELS] = {0.0, 0.0, 0.0, 0.0, 0.0};       // Floor offsets (0.0-1.0)
+    float ceiling[CHANNELS] = {1.0, 1.0, 1.0, 1.0, 1.0};     // Ceiling offsets (0.0-1.0)
+    uint8_t cc[CHANNELS] = {1, 2, 3, 4, 5};                  // MIDI CC assignments
+    uint8_t resolution[CHANNELS] = {0, 0, 0, 0, 0};          // Controller resolution (CcResolution)
 
     // Display settings
     uint16_t screenSleep = 10;
@@ -133,18 +119,21 @@ class UserSettings {
     bool usbMidiEnabled = true;    // USB MIDI enabled by default
     bool hwMidiEnabled = true;     // Hardware MIDI enabled by default
     
+    // Adaptive sampling
+    uint16_t activeSampleRate = 8000;      // Hz while playing
+    uint16_t idleSampleRate = 1000;        // Hz when quiet
+    float activityBreathThreshold = 0.02;  // normalized breath level
+    float activityMotionThreshold = 20.0;  // degrees per second
+    uint16_t idleTimeout = 2000;           // ms without activity before idling
+    uint8_t idleImuInterval = 50;          // ms between IMU reads when idle
+    
+    ModSlot modSlots[MOD_SLOTS];
+    CurvePoints userCurves[USER_CURVES];
+    
     // EEPROM memory addresses (float = 4 bytes, uint8_t = 1 byte, uint16_t = 2 bytes, bool = 1 byte)
-    static const int ADDR_CAL_BREATH = 0;    // 0-3
-    static const int ADDR_CAL_PINCH = 4;     // 4-7
-    static const int ADDR_CAL_EXP = 8;       // 8-11
-    static const int ADDR_CAL_TILT = 12;     // 12-15
-    static const int ADDR_CAL_NOD = 16;      // 16-19
-    
-    static const int ADDR_BREATH_CC = 20;    // 20
-    static const int ADDR_PINCH_CC = 21;     // 21
-    static const int ADDR_EXP_CC = 22;       // 22
-    static const int ADDR_TILT_CC = 23;      // 23
-    static const int ADDR_NOD_CC = 24;       // 24
+    // Per-channel arrays, one entry per SensorChannel in order
+    static const int ADDR_CAL = 0;           // 0-19
+    static const int ADDR_CC = 20;           // 20-24
     
     static const int ADDR_SCREEN_SLEEP = 25; // 25-26
     static const int ADDR_DISPLAY_BRIGHTNESS = 27; // 27
@@ -152,34 +141,33 @@ class UserSettings {
     static const int ADDR_USB_MIDI_EN = 29;  // 29
     static const int ADDR_HW_MIDI_EN = 30;   // 30
     
-    // Curve settings
-    static const int ADDR_BREATH_CURVE = 31; // 31
-    static const int ADDR_PINCH_CURVE = 32;  // 32
-    static const int ADDR_EXP_CURVE = 33;    // 33
-    static const int ADDR_TILT_CURVE = 34;   // 34
-    static const int ADDR_NOD_CURVE = 35;    // 35
-    
-    // Floor offsets
-    static const int ADDR_BREATH_FLOOR = 36;   // 36-39
-    static const int ADDR_PINCH_FLOOR = 40;    // 40-43
-    static const int ADDR_EXP_FLOOR = 44;      // 44-47
-    static const int ADDR_TILT_FLOOR = 48;     // 48-51
-    static const int ADDR_NOD_FLOOR = 52;      // 52-55
-    
-    // Ceiling offsets
-    static const int ADDR_BREATH_CEILING = 56;  // 56-59
-    static const int ADDR_PINCH_CEILING = 60;   // 60-63
-    static const int ADDR_EXP_CEILING = 64;     // 64-67
-    static const int ADDR_TILT_CEILING = 68;    // 68-71
-    static const int ADDR_NOD_CEILING = 72;     // 72-75
+    static const int ADDR_CURVE = 31;        // 31-35
+    static const int ADDR_FLOOR = 36;        // 36-55
+    static const int ADDR_CEILING = 56;      // 56-75
     
     static const int ADDR_MAGIC = 76;        // 76-79
     static const int ADDR_VERSION = 80;      // 80-83
     
+    // Adaptive sampling
+    static const int ADDR_ACTIVE_SAMPLE_RATE = 84;   // 84-85
+    static const int ADDR_IDLE_SAMPLE_RATE = 86;     // 86-87
+    static const int ADDR_ACTIVITY_BREATH = 88;      // 88-91
+    static const int ADDR_ACTIVITY_MOTION = 92;      // 92-95
+    static const int ADDR_IDLE_TIMEOUT = 96;         // 96-97
+    static const int ADDR_IDLE_IMU_INTERVAL = 98;    // 98
+    
+    static const int ADDR_RESOLUTION = 99;           // 99-103
+    static const int ADDR_MOD_SLOTS = 104;           // 104-135, 8 bytes per slot
+    static const int ADDR_USER_CURVES = 136;         // 136-167, 8 points per curve
+    
     static constexpr uint32_t MAGIC_NUMBER = 0xCAFEBABE;
     
     // Helper functions
     void loadFromEEPROM();
+    void validateSampling();
+    void validateResolutions();
+    void validateModSlots();
+    void validateUserCurves();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "AnalogSampler.h"
+
+AnalogSampler* AnalogSampler::instance = nullptr;
+
+AnalogSampler::AnalogSampler(uint8_t breathPin, uint8_t pinchPin, uint8_t expressionPin)
+    : breathPin(breathPin)
+    , pinchPin(pinchPin)
+    , expressionPin(expressionPin)
+    , sampleRate(0)
+    , running(false)
+{
+}
+
+bool AnalogSampler::begin(uint32_t sampleRateHz) {
+    if (sampleRateHz < MIN_SAMPLE_RATE || sampleRateHz > MAX_SAMPLE_RATE) {
+        return false;
+    }
+
+    // Single conversions keep the ISR short; blocks are averaged downstream
+    analogReadResolution(12);
+    analogReadAveraging(1);
+
+    instance = this;
+    sampleRate = sampleRateHz;
+    blocks.clear();
+
+    running = timer.begin(timerISR, 1000000.0f / sampleRate);
+    return running;
+}
+
+void AnalogSampler::end() {
+    timer.end();
+    running = false;
+}
+
+bool AnalogSampler::setSampleRate(uint32_t sampleRateHz) {
+    if (sampleRateHz < MIN_SAMPLE_RATE || sampleRateHz > MAX_SAMPLE_RATE) {
+        return false;
+    }
+    if (sampleRateHz == sampleRate) {
+        return true;
+    }
+
+    sampleRate = sampleRateHz;
+    if (running) {
+        timer.update(1000000.0f / sampleRate);
+    }
+    return true;
+}
+
+void AnalogSampler::timerISR() {
+    instance->sample();
+}
+
+void AnalogSampler::sample() {
+    uint16_t breath = analogRead(breathPin);
+    uint16_t pinch = analogRead(pinchPin);
+    uint16_t expression = analogRead(expressionPin);
+
+    if (blocks.add(breath, pinch, expression)) {
+        blocks.commit(micros(), ARM_DWT_CYCCNT);
+    }
+}
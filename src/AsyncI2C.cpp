@@ -0,0 +1,135 @@
+#include "AsyncI2C.h"
+
+AsyncI2C* AsyncI2C::instance = nullptr;
+
+AsyncI2C::AsyncI2C(I2CPort& port)
+    : port(port)
+    , commandCount(0)
+    , commandIndex(0)
+    , buffer(nullptr)
+    , length(0)
+    , received(0)
+    , state(I2CState::IDLE)
+    , reported(I2CState::IDLE)
+    , lastError(I2CError::NONE)
+    , errorCount(0)
+    , startTime(0)
+    , timeout(0)
+{
+}
+
+void AsyncI2C::begin() {
+    instance = this;
+    port.attach(portISR);
+}
+
+void AsyncI2C::portISR() {
+    instance->service();
+}
+
+bool AsyncI2C::startRead(uint8_t address, uint8_t reg, uint8_t* buffer, uint8_t length,
+                         uint32_t nowUs, uint32_t timeoutUs) {
+    if (state != I2CState::IDLE || length == 0) {
+        return false;
+    }
+
+    commands[0] = I2C_CMD_START | (address << 1);
+    commands[1] = I2C_CMD_TRANSMIT | reg;
+    commands[2] = I2C_CMD_START | (address << 1) | 1;
+    commands[3] = I2C_CMD_RECEIVE | (length - 1);
+    commands[4] = I2C_CMD_STOP;
+    commandCount = MAX_COMMANDS;
+    commandIndex = 0;
+
+    this->buffer = buffer;
+    this->length = length;
+    received = 0;
+
+    startTime = nowUs;
+    timeout = timeoutUs;
+    lastError = I2CError::NONE;
+    state = I2CState::BUSY;
+
+    // The empty command FIFO raises the first interrupt, which starts the
+    // transfer, so commands are only ever pushed from service()
+    port.clearStatus(I2C_STATUS_STOP | I2C_STATUS_ERRORS);
+    port.enableInterrupts(true, true);
+    return true;
+}
+
+void AsyncI2C::service() {
+    if (state != I2CState::BUSY) {
+        port.enableInterrupts(false, false);
+        return;
+    }
+
+    uint32_t flags = port.status();
+    if (flags & I2C_STATUS_NAK) {
+        fail(I2CError::NAK);
+        return;
+    }
+    if (flags & I2C_STATUS_ARB_LOST) {
+        fail(I2CError::ARBITRATION_LOST);
+        return;
+    }
+    if (flags & I2C_STATUS_FIFO_ERROR) {
+        fail(I2CError::FIFO_ERROR);
+        return;
+    }
+    if (flags & I2C_STATUS_PIN_LOW) {
+        fail(I2CError::PIN_LOW_TIMEOUT);
+        return;
+    }
+
+    while (commandIndex < commandCount && port.commandSpace() > 0) {
+        port.pushCommand(commands[commandIndex++]);
+    }
+
+    uint8_t data;
+    while (received < length && port.popData(data)) {
+        buffer[received++] = data;
+    }
+
+    if (flags & I2C_STATUS_STOP) {
+        // All received bytes are in the FIFO before STOP goes out
+        port.clearStatus(I2C_STATUS_STOP);
+        port.enableInterrupts(false, false);
+        if (received == length) {
+            state = I2CState::DONE;
+        } else {
+            fail(I2CError::FIFO_ERROR);
+        }
+        return;
+    }
+
+    port.enableInterrupts(true, commandIndex < commandCount);
+}
+
+I2CState AsyncI2C::poll(uint32_t nowUs) {
+    if (state == I2CState::BUSY && nowUs - startTime > timeout) {
+        port.enableInterrupts(false, false);
+        // The ISR may have completed the transfer before interrupts went off
+        if (state == I2CState::BUSY) {
+            fail(I2CError::TIMEOUT);
+        }
+    }
+    reported = state;
+    return reported;
+}
+
+void AsyncI2C::acknowledge() {
+    // The ISR only moves a BUSY transfer on, so a reported result is
+    // still the current state
+    if (reported == I2CState::DONE || reported == I2CState::FAILED) {
+        state = I2CState::IDLE;
+        reported = I2CState::IDLE;
+    }
+}
+
+void AsyncI2C::fail(I2CError error) {
+    port.enableInterrupts(false, false);
+    port.abort();
+    lastError = error;
+    errorCount++;
+    state = I2CState::FAILED;
+}
@@ -6,34 +6,86 @@ const unsigned long initialRepeatDelay = 200; // Initial delay between repeats (
 const unsigned long minRepeatDelay = 50; // Minimum delay between repeats (ms)
 const unsigned long accelerationTime = 2000; // Time to reach max speed (ms)
 
+ButtonHandler* ButtonHandler::handlers[MAX_BUTTONS];
+uint8_t ButtonHandler::handlerCount = 0;
+BlockRing<ButtonEvent, 64> ButtonHandler::events;
+volatile bool ButtonHandler::eventsLost = false;
+
 ButtonHandler::ButtonHandler(int pin, void (*callback)()):m_pin(pin), m_callback(callback){
     pinMode(pin, INPUT_PULLUP);
+    if (handlerCount < MAX_BUTTONS) {
+      handlers[handlerCount++] = this;
+    }
+}
+
+// attachInterrupt() takes no argument, so each button gets its own handler
+template <uint8_t Index>
+void ButtonHandler::pinChanged() {
+  ButtonEvent event;
+  event.button = Index;
+  event.pressed = digitalRead(handlers[Index]->m_pin) == LOW;
+  event.time = millis();
+  if (!events.push(event)) {
+    eventsLost = true;
+  }
 }
 
-void ButtonHandler::update() {
-  int reading = digitalRead(m_pin);
+void ButtonHandler::begin() {
+  static void (* const pinHandlers[MAX_BUTTONS])() = {
+    pinChanged<0>, pinChanged<1>, pinChanged<2>, pinChanged<3>
+  };
 
-  if (reading != lastButtonState) {
-    lastDebounceTime = millis();
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < handlerCount; i++) {
+    handlers[i]->resync(now);
+    attachInterrupt(digitalPinToInterrupt(handlers[i]->m_pin), pinHandlers[i], CHANGE);
+  }
+}
+
+void ButtonHandler::dispatch() {
+  ButtonEvent event;
+  while (events.pop(event)) {
+    handlers[event.button]->edge(event.pressed, event.time);
   }
 
-  if ((millis() - lastDebounceTime) > debounceDelay) {
-    if (reading != buttonState) {
-      buttonState = reading;
+  // Taken after the drain, so no edge is newer than now
+  uint32_t now = millis();
+  if (eventsLost) {
+    eventsLost = false;
+    for (uint8_t i = 0; i < handlerCount; i++) {
+      handlers[i]->resync(now);
+    }
+  }
 
-      if (buttonState == LOW) {
-        // Button just pressed
-        buttonPressTime = millis();
-        buttonIsHeld = true;
-        lastRepeatTime = millis();
+  for (uint8_t i = 0; i < handlerCount; i++) {
+    handlers[i]->update(now);
+  }
+}
+
+void ButtonHandler::edge(bool pressed, uint32_t time) {
+  // Every edge restarts the debounce time, bounces included
+  rawPressed = pressed;
+  lastEdgeTime = time;
+}
+
+void ButtonHandler::resync(uint32_t now) {
+  edge(digitalRead(m_pin) == LOW, now);
+}
+
+void ButtonHandler::update(uint32_t now) {
+  if ((now - lastEdgeTime) > debounceDelay) {
+    if (rawPressed != buttonIsHeld) {
+      buttonIsHeld = rawPressed;
+
+      if (buttonIsHeld) {
+        // Button just pressed; hold time counts from the edge
+        buttonPressTime = lastEdgeTime;
+        lastRepeatTime = now;
         m_callback(); // Trigger initial press
-      } else {
-        // Button released
-        buttonIsHeld = false;
       }
-    } else if (buttonState == LOW && buttonIsHeld) {
+    } else if (buttonIsHeld) {
       // Button is being held
-      unsigned long holdDuration = millis() - buttonPressTime;
+      unsigned long holdDuration = now - buttonPressTime;
       
       if (holdDuration >= holdThreshold) {
         // Calculate repeat delay with progressive acceleration
@@ -48,15 +100,13 @@ void ButtonHandler::update() {
                        ((initialRepeatDelay - minRepeatDelay) * progressTime / accelerationTime);
         }
         
-        if (millis() - lastRepeatTime >= repeatDelay) {
-          lastRepeatTime = millis();
+        if (now - lastRepeatTime >= repeatDelay) {
+          lastRepeatTime = now;
           m_callback(); // Trigger repeat action
         }
       }
     }
   }
-
-  lastButtonState = reading;
 }
 
 bool ButtonHandler::isHeld() {
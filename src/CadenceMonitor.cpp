@@ -0,0 +1,43 @@
+#include "CadenceMonitor.h"
+
+CadenceMonitor::CadenceMonitor(uint32_t periodUs, uint32_t toleranceUs)
+    : period(periodUs)
+    , tolerance(toleranceUs)
+    , lastStart(0)
+    , started(false)
+    , resetPending(false)
+{
+    clear();
+}
+
+void CadenceMonitor::clear() {
+    stats.ticks = 0;
+    stats.minIntervalUs = 0xFFFFFFFF;
+    stats.maxIntervalUs = 0;
+    stats.lateTicks = 0;
+    stats.maxRunUs = 0;
+    started = false;
+}
+
+void CadenceMonitor::record(uint32_t startUs, uint32_t endUs) {
+    if (resetPending) {
+        resetPending = false;
+        clear();
+    }
+
+    // The first run after a reset has no interval to measure
+    if (started) {
+        uint32_t interval = startUs - lastStart;
+        if (interval < stats.minIntervalUs) stats.minIntervalUs = interval;
+        if (interval > stats.maxIntervalUs) stats.maxIntervalUs = interval;
+        uint32_t error = interval > period ? interval - period : period - interval;
+        if (error > tolerance) stats.lateTicks++;
+    }
+    lastStart = startUs;
+    started = true;
+
+    stats.ticks++;
+    if (endUs - startUs > stats.maxRunUs) stats.maxRunUs = endUs - startUs;
+
+    published.write(stats);
+}
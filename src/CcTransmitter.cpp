@@ -0,0 +1,162 @@
+#include "CcTransmitter.h"
+
+CcTransmitter::CcTransmitter(MidiSink& usb, MidiSink& din)
+    : sinks{&usb, &din}
+    , hysteresis(1)
+    , highResHysteresis(4)
+    , refreshInterval(0)
+    , lastRefresh(0)
+    , refreshRound(0)
+{
+    invalidate();
+    resetCounters();
+}
+
+bool CcTransmitter::send(MidiPort port, uint8_t channel, uint8_t control, uint8_t value) {
+    uint8_t p = (uint8_t)port;
+    if (p >= PORTS || channel < 1 || channel > CHANNELS || control >= CONTROLS) {
+        return false;
+    }
+    requested[p]++;
+
+    if (!accept(controls[p][channel - 1][control], value, 127, hysteresis)) {
+        return false;
+    }
+    sinks[p]->controlChange(control, value, channel);
+    sent[p]++;
+    return true;
+}
+
+bool CcTransmitter::sendHighRes(MidiPort port, uint8_t channel, uint8_t control, uint16_t value) {
+    uint8_t p = (uint8_t)port;
+    if (p >= PORTS || channel < 1 || channel > CHANNELS || control >= HIGH_RES_CONTROLS) {
+        return false;
+    }
+    requested[p]++;
+
+    if (!accept(highRes[p][channel - 1][control], value, 0x3FFF, highResHysteresis)) {
+        return false;
+    }
+    sinks[p]->highResControl(control, value, channel);
+    sent[p]++;
+    return true;
+}
+
+bool CcTransmitter::sendNrpn(MidiPort port, uint8_t channel, uint8_t parameter, uint16_t value) {
+    uint8_t p = (uint8_t)port;
+    if (p >= PORTS || channel < 1 || channel > CHANNELS || parameter >= CONTROLS) {
+        return false;
+    }
+    requested[p]++;
+
+    if (!accept(nrpns[p][channel - 1][parameter], value, 0x3FFF, highResHysteresis)) {
+        return false;
+    }
+    sinks[p]->nrpn(parameter, value, channel);
+    sent[p]++;
+    return true;
+}
+
+bool CcTransmitter::sendPitchBend(MidiPort port, uint8_t channel, uint16_t value) {
+    uint8_t p = (uint8_t)port;
+    if (p >= PORTS || channel < 1 || channel > CHANNELS) {
+        return false;
+    }
+    requested[p]++;
+
+    if (!accept(pitchBends[p][channel - 1], value, 0x3FFF, highResHysteresis, 8192)) {
+        return false;
+    }
+    sinks[p]->pitchBend(value, channel);
+    sent[p]++;
+    return true;
+}
+
+bool CcTransmitter::sendPressure(MidiPort port, uint8_t channel, uint8_t value) {
+    uint8_t p = (uint8_t)port;
+    if (p >= PORTS || channel < 1 || channel > CHANNELS) {
+        return false;
+    }
+    requested[p]++;
+
+    if (!accept(pressures[p][channel - 1], value, 127, hysteresis)) {
+        return false;
+    }
+    sinks[p]->channelPressure(value, channel);
+    sent[p]++;
+    return true;
+}
+
+bool CcTransmitter::accept(Entry& entry, uint16_t value, uint16_t maxValue, uint16_t band, uint16_t rest) {
+    bool refreshDue = entry.round != refreshRound;
+
+    if ((entry.flags & FLAG_VALID) && !refreshDue) {
+        if (value == entry.value) {
+            return false;
+        }
+
+        // Keep going freely in the same direction, but a reversal has to
+        // clear the band. The end stops and the rest value always go out so
+        // a released breath lands on exactly 0 and a bend on center.
+        bool rising = value > entry.value;
+        uint16_t delta = rising ? value - entry.value : entry.value - value;
+        bool reversal = (entry.flags & (rising ? FLAG_FALLING : FLAG_RISING)) != 0;
+        bool endStop = value == 0 || value == maxValue || value == rest;
+        if (reversal && delta <= band && !endStop) {
+            return false;
+        }
+    }
+
+    uint8_t flags = FLAG_VALID;
+    if (entry.flags & FLAG_VALID) {
+        if (value > entry.value) {
+            flags |= FLAG_RISING;
+        } else if (value < entry.value) {
+            flags |= FLAG_FALLING;
+        } else {
+            flags = entry.flags; // refresh of an unchanged value
+        }
+    }
+    entry.value = value;
+    entry.flags = flags;
+    entry.round = refreshRound;
+    return true;
+}
+
+void CcTransmitter::update(uint32_t nowMs) {
+    if (refreshInterval == 0) {
+        lastRefresh = nowMs;
+        return;
+    }
+    if (nowMs - lastRefresh >= refreshInterval) {
+        lastRefresh = nowMs;
+        // Every entry now belongs to an older round, so each is resent once
+        refreshRound++;
+        for (uint8_t p = 0; p < PORTS; p++) {
+            sinks[p]->refresh();
+        }
+    }
+}
+
+void CcTransmitter::clear(Entry* entries, uint16_t count, uint8_t round) {
+    for (uint16_t i = 0; i < count; i++) {
+        entries[i].value = 0;
+        entries[i].flags = 0;
+        entries[i].round = round;
+    }
+}
+
+void CcTransmitter::invalidate() {
+    clear(&controls[0][0][0], PORTS * CHANNELS * CONTROLS, refreshRound);
+    clear(&highRes[0][0][0], PORTS * CHANNELS * HIGH_RES_CONTROLS, refreshRound);
+    clear(&nrpns[0][0][0], PORTS * CHANNELS * CONTROLS, refreshRound);
+    clear(&pitchBends[0][0], PORTS * CHANNELS, refreshRound);
+    clear(&pressures[0][0], PORTS * CHANNELS, refreshRound);
+}
+
+void CcTransmitter::resetCounters() {
+    for (uint8_t p = 0; p < PORTS; p++) {
+        requested[p] = 0;
+        sent[p] = 0;
+    }
+}
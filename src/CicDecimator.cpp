@@ -0,0 +1,64 @@
+#include "CicDecimator.h"
+
+// Compensator taps are [-1, 10, -1] / 8, which cancels the second-order
+// droop of sinc^3 in the CIC passband. CIC gain is RATIO^ORDER = 2^12 and
+// the output is 16 bits, so the combined scale is a shift by 3 + 8.
+static const uint8_t OUTPUT_SHIFT = 3 + 8;
+
+CicDecimator::CicDecimator() {
+    reset(0);
+}
+
+void CicDecimator::reset(uint16_t value) {
+    for (uint8_t i = 0; i < ORDER; i++) {
+        integrator[i] = 0;
+        comb[i] = 0;
+    }
+    history[0] = 0;
+    history[1] = 0;
+
+    uint16_t block[RATIO];
+    for (uint8_t i = 0; i < RATIO; i++) {
+        block[i] = value;
+    }
+    for (uint8_t i = 0; i < ORDER + 2; i++) {
+        process(block);
+    }
+}
+
+uint16_t CicDecimator::process(const uint16_t* samples) {
+    uint32_t i0 = integrator[0];
+    uint32_t i1 = integrator[1];
+    uint32_t i2 = integrator[2];
+
+    for (uint8_t n = 0; n < RATIO; n++) {
+        i0 += samples[n];
+        i1 += i0;
+        i2 += i1;
+    }
+
+    integrator[0] = i0;
+    integrator[1] = i1;
+    integrator[2] = i2;
+
+    uint32_t c0 = i2 - comb[0];
+    comb[0] = i2;
+    uint32_t c1 = c0 - comb[1];
+    comb[1] = c0;
+    uint32_t c2 = c1 - comb[2];
+    comb[2] = c1;
+
+    int32_t cicOut = (int32_t)c2;
+    int32_t compensated = 10 * history[0] - history[1] - cicOut;
+    history[1] = history[0];
+    history[0] = cicOut;
+
+    compensated = (compensated + (1 << (OUTPUT_SHIFT - 1))) >> OUTPUT_SHIFT;
+    if (compensated < 0) {
+        return 0;
+    }
+    if (compensated > FULL_SCALE) {
+        return FULL_SCALE;
+    }
+    return (uint16_t)compensated;
+}
@@ -0,0 +1,76 @@
+#include "CycleProfiler.h"
+
+CycleProfiler::CycleProfiler(ClockFunction clock, uint32_t windowCycles)
+    : clock(clock)
+    , window(windowCycles)
+    , sectionCount(0)
+{
+}
+
+uint8_t CycleProfiler::addSection(const char* name, uint32_t budgetCycles) {
+    if (sectionCount >= MAX_SECTIONS) {
+        return NO_SECTION;
+    }
+
+    Section& section = sections[sectionCount];
+    section.profile.name = name;
+    section.budget = budgetCycles;
+    clear(section, clock());
+    return sectionCount++;
+}
+
+void CycleProfiler::clear(Section& section, uint32_t now) {
+    section.profile.runs = 0;
+    section.profile.lastCycles = 0;
+    section.profile.meanCycles = 0;
+    section.profile.worstCycles = 0;
+    section.profile.peakCycles = 0;
+    section.profile.overruns = 0;
+    section.windowStart = now;
+    section.windowRuns = 0;
+    section.windowTotal = 0;
+    section.windowWorst = 0;
+}
+
+void CycleProfiler::stop(uint8_t section, uint32_t startCycles) {
+    record(section, clock() - startCycles);
+}
+
+void CycleProfiler::record(uint8_t index, uint32_t cycles) {
+    if (index >= sectionCount) {
+        return;
+    }
+
+    Section& section = sections[index];
+    SectionProfile& profile = section.profile;
+    profile.runs++;
+    profile.lastCycles = cycles;
+    if (cycles > profile.peakCycles) profile.peakCycles = cycles;
+    if (section.budget && cycles > section.budget) profile.overruns++;
+
+    section.windowRuns++;
+    section.windowTotal += cycles;
+    if (cycles > section.windowWorst) section.windowWorst = cycles;
+
+    // Publish the window once it has run its length
+    uint32_t now = clock();
+    if (now - section.windowStart >= window) {
+        profile.meanCycles = (uint32_t)(section.windowTotal / section.windowRuns);
+        profile.worstCycles = section.windowWorst;
+        section.windowStart = now;
+        section.windowRuns = 0;
+        section.windowTotal = 0;
+        section.windowWorst = 0;
+    }
+}
+
+SectionProfile CycleProfiler::getProfile(uint8_t section) const {
+    return sections[section < sectionCount ? section : 0].profile;
+}
+
+void CycleProfiler::reset() {
+    uint32_t now = clock();
+    for (uint8_t i = 0; i < sectionCount; i++) {
+        clear(sections[i], now);
+    }
+}
@@ -0,0 +1,283 @@
+#include "DinScheduler.h"
+
+DinScheduler::DinScheduler(SpaceFunction space, WriteFunction write)
+    : space(space)
+    , write(write)
+    , tokens(BURST_BYTES * TOKEN_SCALE)
+    , lastService(0)
+    , started(false)
+    , now(0)
+    , runningStatus(0)
+    , runningStatusSince(0)
+{
+    for (uint8_t i = 0; i < SLOTS; i++) {
+        slots[i].used = false;
+    }
+    resetControlPriorities();
+    resetRunningStatus();
+    resetStats();
+}
+
+uint8_t DinScheduler::messageLength(uint8_t status) {
+    uint8_t type = status & 0xF0;
+    return (type == 0xC0 || type == 0xD0) ? 2 : 3;
+}
+
+bool DinScheduler::sameDestination(const Slot& slot, Kind kind, uint8_t status, uint16_t number) {
+    if (slot.kind != kind || slot.status != status) {
+        return false;
+    }
+    // Controllers and poly pressure are per key/controller, the rest per channel
+    uint8_t type = status & 0xF0;
+    if (kind != KIND_MESSAGE || type == 0xB0 || type == 0xA0) {
+        return slot.number == number;
+    }
+    return true;
+}
+
+bool DinScheduler::enqueue(uint8_t status, uint8_t data1, uint8_t data2, uint8_t priority) {
+    return enqueueSlot(KIND_MESSAGE, status, data1 & 0x7F, data2 & 0x7F, priority);
+}
+
+void DinScheduler::controlChange(uint8_t control, uint8_t value, uint8_t channel) {
+    control &= 0x7F;
+    uint8_t status = 0xB0 | ((channel - 1) & 0x0F);
+    enqueueSlot(KIND_MESSAGE, status, control, value & 0x7F, controlPriority[control]);
+}
+
+void DinScheduler::highResControl(uint8_t control, uint16_t value, uint8_t channel) {
+    control &= 0x1F;
+    uint8_t status = 0xB0 | ((channel - 1) & 0x0F);
+    enqueueSlot(KIND_HIGH_RES, status, control, value & 0x3FFF, controlPriority[control]);
+}
+
+void DinScheduler::nrpn(uint16_t parameter, uint16_t value, uint8_t channel) {
+    parameter &= 0x3FFF;
+    uint8_t status = 0xB0 | ((channel - 1) & 0x0F);
+    enqueueSlot(KIND_NRPN, status, parameter, value & 0x3FFF, controlPriority[parameter & 0x7F]);
+}
+
+void DinScheduler::pitchBend(uint16_t value, uint8_t channel) {
+    uint8_t status = 0xE0 | ((channel - 1) & 0x0F);
+    enqueue(status, value & 0x7F, (value >> 7) & 0x7F, PRIORITY_HIGHEST);
+}
+
+void DinScheduler::channelPressure(uint8_t value, uint8_t channel) {
+    uint8_t status = 0xD0 | ((channel - 1) & 0x0F);
+    enqueue(status, value & 0x7F, 0, PRIORITY_HIGHEST);
+}
+
+bool DinScheduler::enqueueSlot(Kind kind, uint8_t status, uint16_t number, uint16_t value, uint8_t priority) {
+    Slot* freeSlot = nullptr;
+    Slot* weakest = nullptr;
+
+    for (uint8_t i = 0; i < SLOTS; i++) {
+        Slot& slot = slots[i];
+        if (!slot.used) {
+            if (freeSlot == nullptr) {
+                freeSlot = &slot;
+            }
+            continue;
+        }
+        if (sameDestination(slot, kind, status, number)) {
+            // Latest value wins; keep the original queue time so a busy
+            // controller isn't pushed back behind quieter ones
+            slot.value = value;
+            slot.stamp = stamp;
+            if (priority < slot.priority) {
+                slot.priority = priority;
+            }
+            replaced++;
+            return true;
+        }
+        if (weakest == nullptr || slot.priority > weakest->priority) {
+            weakest = &slot;
+        }
+    }
+
+    Slot* target = freeSlot;
+    if (target == nullptr) {
+        // Full: evict something less important, or give up on this one
+        if (weakest == nullptr || weakest->priority <= priority) {
+            dropped++;
+            return false;
+        }
+        target = weakest;
+        dropped++;
+    }
+
+    target->used = true;
+    target->kind = kind;
+    target->status = status;
+    target->number = number;
+    target->value = value;
+    target->priority = priority;
+    target->queuedAt = now;
+    target->stamp = stamp;
+    return true;
+}
+
+void DinScheduler::resetControlPriorities() {
+    for (uint8_t i = 0; i < 128; i++) {
+        controlPriority[i] = PRIORITY_LOWEST;
+    }
+}
+
+void DinScheduler::resetRunningStatus() {
+    runningStatus = 0;
+    for (uint8_t i = 0; i < 16; i++) {
+        selectedParameter[i] = NO_PARAMETER;
+    }
+}
+
+void DinScheduler::appendControl(uint8_t*& out, uint8_t status, uint8_t control, uint8_t value,
+                                 uint8_t& currentStatus, uint8_t& saved) const {
+    if (status == currentStatus) {
+        saved++;
+    } else {
+        *out++ = status;
+        currentStatus = status;
+    }
+    *out++ = control;
+    *out++ = value;
+}
+
+uint8_t DinScheduler::encode(const Slot& slot, uint8_t* out, uint8_t& saved) const {
+    uint8_t* start = out;
+    uint8_t currentStatus = runningStatus;
+    saved = 0;
+
+    if (slot.kind == KIND_MESSAGE) {
+        if (slot.status == currentStatus) {
+            saved++;
+        } else {
+            *out++ = slot.status;
+        }
+        *out++ = slot.number;
+        if (messageLength(slot.status) == 3) {
+            *out++ = slot.value;
+        }
+    } else if (slot.kind == KIND_HIGH_RES) {
+        appendControl(out, slot.status, slot.number, slot.value >> 7, currentStatus, saved);
+        appendControl(out, slot.status, slot.number + 32, slot.value & 0x7F, currentStatus, saved);
+    } else {
+        if (selectedParameter[slot.status & 0x0F] != slot.number) {
+            appendControl(out, slot.status, 99, slot.number >> 7, currentStatus, saved);
+            appendControl(out, slot.status, 98, slot.number & 0x7F, currentStatus, saved);
+        }
+        appendControl(out, slot.status, 6, slot.value >> 7, currentStatus, saved);
+        appendControl(out, slot.status, 38, slot.value & 0x7F, currentStatus, saved);
+    }
+    return out - start;
+}
+
+void DinScheduler::service(uint32_t nowUs) {
+    now = nowUs;
+    if (!started) {
+        lastService = nowUs;
+        started = true;
+    }
+
+    // Refill the byte budget at the wire rate. It is capped at a small
+    // burst, or at the size of a longer group that is saving up for itself.
+    uint32_t elapsed = nowUs - lastService;
+    lastService = nowUs;
+    const uint32_t maxTokens = MAX_GROUP_BYTES * TOKEN_SCALE;
+    if (elapsed >= maxTokens / WIRE_BYTES_PER_SECOND) {
+        tokens = maxTokens;
+    } else {
+        tokens += elapsed * WIRE_BYTES_PER_SECOND;
+        if (tokens > maxTokens) {
+            tokens = maxTokens;
+        }
+    }
+    uint32_t cap = BURST_BYTES * TOKEN_SCALE;
+
+    if (runningStatus != 0 && nowUs - runningStatusSince >= RUNNING_STATUS_REFRESH_US) {
+        resetRunningStatus();
+    }
+
+    while (true) {
+        // Highest priority first. Within a priority, messages continuing
+        // the running status go first, then the oldest.
+        Slot* next = nullptr;
+        for (uint8_t i = 0; i < SLOTS; i++) {
+            Slot& slot = slots[i];
+            if (!slot.used) {
+                continue;
+            }
+            if (next == nullptr || slot.priority < next->priority) {
+                next = &slot;
+                continue;
+            }
+            if (slot.priority > next->priority) {
+                continue;
+            }
+            bool slotRuns = slot.status == runningStatus;
+            bool nextRuns = next->status == runningStatus;
+            if (slotRuns != nextRuns) {
+                if (slotRuns) {
+                    next = &slot;
+                }
+            } else if ((int32_t)(slot.queuedAt - next->queuedAt) < 0) {
+                next = &slot;
+            }
+        }
+        if (next == nullptr) {
+            break;
+        }
+
+        uint8_t message[MAX_GROUP_BYTES];
+        uint8_t saved;
+        uint8_t length = encode(*next, message, saved);
+
+        // A group only goes out whole and is charged every byte, so NRPNs
+        // get no more than their share of the wire
+        uint32_t cost = length * TOKEN_SCALE;
+        if (tokens < cost || space() < length) {
+            if (cost > cap) {
+                cap = cost;
+            }
+            break;
+        }
+
+        write(message, length);
+        handedOff(next->stamp);
+        tokens -= cost;
+        bytesSaved += saved;
+        if (next->status != runningStatus) {
+            runningStatusSince = nowUs; // status byte went out in full
+        }
+        runningStatus = next->status;
+        if (next->kind == KIND_NRPN) {
+            selectedParameter[next->status & 0x0F] = next->number;
+        }
+
+        uint32_t latency = nowUs - next->queuedAt;
+        if (latency > worstLatencyUs) {
+            worstLatencyUs = latency;
+        }
+        next->used = false;
+    }
+
+    if (tokens > cap) {
+        tokens = cap;
+    }
+}
+
+uint8_t DinScheduler::pending() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < SLOTS; i++) {
+        if (slots[i].used) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void DinScheduler::resetStats() {
+    replaced = 0;
+    dropped = 0;
+    worstLatencyUs = 0;
+    bytesSaved = 0;
+}
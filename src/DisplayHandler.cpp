@@ -1,4 +1,6 @@
 #include "DisplayHandler.h"
+#include "CcTransmitter.h"
+#include "ButtonHandler.h"
 
 const unsigned long LOADING_DURATION = 2000;
 
@@ -18,6 +20,7 @@ const uint16_t COLOR_ACCENT = ILI9341_ORANGE;
 const char* mainMenuItems[] = {
   "Sensors",
   "MIDI",
+  "Matrix",
   "Device",
   "About"
 };
@@ -49,14 +52,73 @@ const char* midiSubMenu[] = {
   "Nod CC",
   "USB MIDI",
   "Hardware MIDI",
+  "Breath Res",
+  "Pinch Res",
+  "Expression Res",
+  "Tilt Res",
+  "Nod Res",
   "Reset MIDI"
 };
 
+// Labels for CcResolution values
+const char* resolutionNames[] = {
+  "7-bit",
+  "14-bit",
+  "NRPN"
+};
+
+
+
+// Matrix sub-menu (second level) - user routes
+const char* matrixSubMenu[] = {
+  "Slot 1",
+  "Slot 2",
+  "Slot 3",
+  "Slot 4",
+  "Reset Matrix"
+};
+
+// Third-level items under each matrix slot
+const char* matrixSlotMenu[] = {
+  "Source",
+  "Destination",
+  "Number",
+  "Amount",
+  "Curve",
+  "Floor",
+  "Ceiling"
+};
+
+// Edit range of each matrix slot item
+const int matrixItemMin[] = {0, 0, 0, -100, 1, 0, 0};
+const int matrixItemMax[] = {(int)ModSource::COUNT - 1, (int)ModDestination::COUNT - 1, 127, 100, CURVE_SETTING_MAX, 100, 100};
+
+// Labels for ModSource and ModDestination values
+const char* modSourceNames[] = {
+  "Breath",
+  "Pinch",
+  "Expression",
+  "Tilt",
+  "Nod",
+  "Twist",
+  "Roll",
+  "Pitch",
+  "Yaw"
+};
 
+const char* modDestinationNames[] = {
+  "Off",
+  "CC",
+  "14-bit CC",
+  "NRPN",
+  "Pitch Bend",
+  "Pressure"
+};
 
 const char* deviceSettingsSubMenu[] = {
   "Display Brightness",
   "Sleep Timeout",
+  "Latency",
   "Factory Reset"
 };
 
@@ -67,6 +129,17 @@ DisplayHandler::DisplayHandler(SensorCache& sensorCache, UserSettings& userSetti
 {
 }
 
+void DisplayHandler::setLatencySource(LatencyReadFunction read, ResetFunction reset) {
+  readLatency = read;
+  resetLatency = reset;
+}
+
+void DisplayHandler::setProfileSource(ProfileReadFunction read, uint8_t sections, ResetFunction reset) {
+  readProfile = read;
+  profileSections = sections;
+  resetProfile = reset;
+}
+
 void DisplayHandler::begin() {
   // Turn backlight OFF first
   pinMode(TFT_BL, OUTPUT);
@@ -88,12 +161,17 @@ void DisplayHandler::begin() {
 }
 
 void DisplayHandler::update() {
+  // Button presses queued since the last update; the press callbacks
+  // redraw here instead of inside the input interrupt
+  ButtonHandler::dispatch();
+  
   unsigned long currentTime = millis();
   
   // Check for sleep timeout (disabled on sensor setting screens to allow monitoring)
   if (displayState == DisplayState::DISPLAY_ON) {
-    // Skip timeout check on sensor detail screens
-    if (!(menuDepth == 3 && mainMenuSelection == 0)) {
+    // Skip timeout check on sensor detail and diagnostic screens
+    if (!(menuDepth == 3 && mainMenuSelection == 0) && currentState != MenuState::LATENCY && currentState != MenuState::PROFILE &&
+        currentState != MenuState::SENSOR_VALUES) {
       unsigned long sleepTimeout = m_userSettings.getScreenSleep() * 1000; // Convert seconds to milliseconds
       if (currentTime - lastActivityTime > sleepTimeout) {
         sleep();
@@ -118,7 +196,69 @@ void DisplayHandler::update() {
     }
   }
   
-  // Sensor values screen draws once on entry, not continuously updated
+  // Diagnostic figures refresh twice a second
+  if (displayState == DisplayState::DISPLAY_ON && currentTime - lastDiagnosticUpdate > 500) {
+    if (currentState == MenuState::LATENCY) {
+      lastDiagnosticUpdate = currentTime;
+      drawLatency();
+    } else if (currentState == MenuState::PROFILE) {
+      lastDiagnosticUpdate = currentTime;
+      drawProfile();
+    }
+  }
+  
+  // Sensor values refresh at 10Hz. The IMU fields are requested on entry,
+  // so the snapshot drawn on entry may still lack them; later ones don't.
+  if (displayState == DisplayState::DISPLAY_ON && currentState == MenuState::SENSOR_VALUES &&
+      currentTime - lastDiagnosticUpdate > 100) {
+    lastDiagnosticUpdate = currentTime;
+    drawSensorValues();
+  }
+  
+  updateImuDemand();
+}
+
+int DisplayHandler::getMatrixValue(int item) {
+  // subMenuSelection = slot, item 0-6 = Source, Destination, Number, Amount, Curve, Floor, Ceiling
+  const ModSlot& slot = m_userSettings.getModSlot(subMenuSelection);
+  if (item == 0) return (int)slot.source;
+  if (item == 1) return (int)slot.destination;
+  if (item == 2) return slot.number;
+  if (item == 3) return slot.amount;
+  if (item == 4) return slot.curve;
+  if (item == 5) return slot.floor;
+  return slot.ceiling;
+}
+
+void DisplayHandler::setMatrixValue(int item, int value) {
+  ModSlot slot = m_userSettings.getModSlot(subMenuSelection);
+  if (item == 0) slot.source = (ModSource)value;
+  else if (item == 1) slot.destination = (ModDestination)value;
+  else if (item == 2) slot.number = value;
+  else if (item == 3) slot.amount = value;
+  else if (item == 4) slot.curve = value;
+  else if (item == 5) slot.floor = value;
+  else slot.ceiling = value;
+  m_userSettings.setModSlot(subMenuSelection, slot);
+}
+
+String DisplayHandler::matrixValueText(int item, int value) {
+  if (item == 0) return modSourceNames[value];
+  if (item == 1) return modDestinationNames[value];
+  if (item == 3 || item == 5 || item == 6) return String(value) + "%";
+  if (item == 4) return curveText(value);
+  return String(value);
+}
+
+void DisplayHandler::updateImuDemand() {
+  uint8_t fields = screenImuFields;
+  
+  // Tilt and nod detail screens track gyro on the curve indicator
+  if (displayState == DisplayState::DISPLAY_ON && menuDepth == 3 && mainMenuSelection == 0 && subMenuSelection >= 3) {
+    fields |= IMU_GYRO;
+  }
+  
+  m_sensorCache.requestImuFields(ImuConsumer::DISPLAY, fields);
 }
 
 void DisplayHandler::pressUp() {
@@ -129,7 +269,9 @@ void DisplayHandler::pressUp() {
   
   lastActivityTime = millis();
   
-  if (inlineEditMode) {
+  if (pointEditMode) {
+    adjustCurvePoint(pointStep);
+  } else if (inlineEditMode) {
     if (editingFloat) {
       // Floor and ceiling use 0.01 increment, calibration uses 0.1
       float increment = (menuDepth == 3 && (thirdMenuSelection == 2 || thirdMenuSelection == 3)) ? 0.01 : 0.1;
@@ -139,27 +281,31 @@ void DisplayHandler::pressUp() {
       if (editValueFloat > maxFloat) editValueFloat = maxFloat;
     } else {
       // Increment by 5 for sleep timeout, by 1 for others
-      int increment = (mainMenuSelection == 2 && subMenuSelection == 1) ? 5 : 1;
+      int increment = (mainMenuSelection == 3 && subMenuSelection == 1) ? 5 : 1;
       editValue += increment;
       // Apply context-specific max values
       int maxVal = 255;
       if (mainMenuSelection == 1) { // MIDI
         if (subMenuSelection == 0) maxVal = 16; // MIDI Channel 1-16
         else if (subMenuSelection >= 1 && subMenuSelection <= 5) maxVal = 127; // CC 0-127
+        else if (subMenuSelection >= 8 && subMenuSelection <= 12) maxVal = (int)CcResolution::COUNT - 1; // Resolution
         else maxVal = 1; // Boolean ON/OFF
       } else if (mainMenuSelection == 0 && menuDepth == 3 && thirdMenuSelection == 1) { // Sensor Curve
-        maxVal = 4; // Curve settings: 1-4 (linear, concave, convex, s-curve)
-      } else if (mainMenuSelection == 2) { // Device
+        maxVal = CURVE_SETTING_MAX; // Curve settings: 1-10 presets (SignalChain::CURVE_SHAPES), then user curves
+      } else if (mainMenuSelection == 2 && menuDepth == 3) { // Matrix slot
+        maxVal = matrixItemMax[thirdMenuSelection];
+      } else if (mainMenuSelection == 3) { // Device
         if (subMenuSelection == 0) maxVal = 10; // Brightness 1-10
         else if (subMenuSelection == 1) maxVal = 90; // Sleep timeout 0-90 seconds
         else maxVal = 1; // Boolean
       }
       if (editValue > maxVal) editValue = maxVal;
-      int minVal = (mainMenuSelection == 2 && subMenuSelection == 0) ? 1 : 0; // Brightness min is 1
+      int minVal = (mainMenuSelection == 3 && subMenuSelection == 0) ? 1 : 0; // Brightness min is 1
+      if (mainMenuSelection == 2 && menuDepth == 3) minVal = matrixItemMin[thirdMenuSelection];
       if (editValue < minVal) editValue = minVal;
       
       // Apply brightness change immediately for preview
-      if (mainMenuSelection == 2 && subMenuSelection == 0) {
+      if (mainMenuSelection == 3 && subMenuSelection == 0) {
         int scaledBrightness = 26 + ((editValue - 1) * 25);
         if (editValue == 10) scaledBrightness = 255;
         analogWrite(TFT_BL, scaledBrightness);
@@ -170,11 +316,12 @@ void DisplayHandler::pressUp() {
     int maxItems;
     if (menuDepth == 2) {
       maxItems = (mainMenuSelection == 0) ? sensorsSubMenuCount :
-                 (mainMenuSelection == 1) ? midiSubMenuCount : deviceSettingsSubMenuCount;
+                 (mainMenuSelection == 1) ? midiSubMenuCount :
+                 (mainMenuSelection == 2) ? matrixSubMenuCount : deviceSettingsSubMenuCount;
       subMenuSelection--;
       if (subMenuSelection < 0) subMenuSelection = maxItems - 1;
     } else { // menuDepth == 3
-      maxItems = sensorDetailMenuCount; // All sensors have 4 settings
+      maxItems = (mainMenuSelection == 2) ? matrixSlotMenuCount : sensorDetailMenuCount;
       thirdMenuSelection--;
       if (thirdMenuSelection < 0) thirdMenuSelection = maxItems - 1;
     }
@@ -194,7 +341,9 @@ void DisplayHandler::pressDown() {
   
   lastActivityTime = millis();
   
-  if (inlineEditMode) {
+  if (pointEditMode) {
+    adjustCurvePoint(-pointStep);
+  } else if (inlineEditMode) {
     if (editingFloat) {
       // Floor and ceiling use 0.01 decrement, calibration uses 0.1
       float decrement = (menuDepth == 3 && (thirdMenuSelection == 2 || thirdMenuSelection == 3)) ? 0.01 : 0.1;
@@ -202,20 +351,21 @@ void DisplayHandler::pressDown() {
       if (editValueFloat < 0.0) editValueFloat = 0.0;
     } else {
       // Decrement by 5 for sleep timeout, by 1 for others
-      int decrement = (mainMenuSelection == 2 && subMenuSelection == 1) ? 5 : 1;
+      int decrement = (mainMenuSelection == 3 && subMenuSelection == 1) ? 5 : 1;
       editValue -= decrement;
       // Apply context-specific min values  
       int minVal = 0;
       if (mainMenuSelection == 1 && subMenuSelection == 0) minVal = 1; // MIDI Channel min 1
-      else if (mainMenuSelection == 2 && subMenuSelection == 0) minVal = 1; // Brightness min 1
-      else if (mainMenuSelection == 2 && subMenuSelection == 1) minVal = 10; // Sleep timeout min 10
+      else if (mainMenuSelection == 3 && subMenuSelection == 0) minVal = 1; // Brightness min 1
+      else if (mainMenuSelection == 3 && subMenuSelection == 1) minVal = 10; // Sleep timeout min 10
       else if (mainMenuSelection == 0 && menuDepth == 3 && thirdMenuSelection == 1) { // Sensor Curve
         minVal = 1; // Curve setting min 1
       }
+      else if (mainMenuSelection == 2 && menuDepth == 3) minVal = matrixItemMin[thirdMenuSelection];
       if (editValue < minVal) editValue = minVal;
       
       // Apply brightness change immediately for preview
-      if (mainMenuSelection == 2 && subMenuSelection == 0) {
+      if (mainMenuSelection == 3 && subMenuSelection == 0) {
         int scaledBrightness = 26 + ((editValue - 1) * 25);
         if (editValue == 10) scaledBrightness = 255;
         analogWrite(TFT_BL, scaledBrightness);
@@ -226,11 +376,12 @@ void DisplayHandler::pressDown() {
     int maxItems;
     if (menuDepth == 2) {
       maxItems = (mainMenuSelection == 0) ? sensorsSubMenuCount :
-                 (mainMenuSelection == 1) ? midiSubMenuCount : deviceSettingsSubMenuCount;
+                 (mainMenuSelection == 1) ? midiSubMenuCount :
+                 (mainMenuSelection == 2) ? matrixSubMenuCount : deviceSettingsSubMenuCount;
       subMenuSelection++;
       if (subMenuSelection >= maxItems) subMenuSelection = 0;
     } else { // menuDepth == 3
-      maxItems = sensorDetailMenuCount; // All sensors have 4 settings
+      maxItems = (mainMenuSelection == 2) ? matrixSlotMenuCount : sensorDetailMenuCount;
       thirdMenuSelection++;
       if (thirdMenuSelection >= maxItems) thirdMenuSelection = 0;
     }
@@ -239,6 +390,14 @@ void DisplayHandler::pressDown() {
     mainMenuSelection++;
     if (mainMenuSelection >= mainMenuCount) mainMenuSelection = 0;
     drawMainMenu();
+  } else if (currentState == MenuState::ABOUT) {
+    // Hidden sensor values screen; ask for every IMU field straight away
+    currentState = MenuState::SENSOR_VALUES;
+    screenImuFields = IMU_ALL;
+    updateImuDemand();
+    needsFullRedraw = true;
+    lastDiagnosticUpdate = millis();
+    drawSensorValues();
   }
 }
 
@@ -250,9 +409,13 @@ void DisplayHandler::pressLeft() {
   
   lastActivityTime = millis();
   
-  if (inlineEditMode) {
+  if (pointEditMode) {
+    // Cancel point edit - drop the unsaved points
+    pointEditMode = false;
+    redrawCurve();
+  } else if (inlineEditMode) {
     // Cancel inline edit - restore saved brightness if editing brightness
-    if (mainMenuSelection == 2 && subMenuSelection == 0) {
+    if (mainMenuSelection == 3 && subMenuSelection == 0) {
       analogWrite(TFT_BL, m_userSettings.getDisplayBrightness());
     }
     inlineEditMode = false;
@@ -287,6 +450,20 @@ void DisplayHandler::pressLeft() {
     currentState = MenuState::MAIN_MENU;
     needsFullRedraw = true;
     drawMainMenu();
+  } else if (currentState == MenuState::LATENCY) {
+    // Back to device settings
+    currentState = MenuState::SUB_MENU;
+    needsFullRedraw = true;
+    drawSubMenu();
+  } else if (currentState == MenuState::PROFILE) {
+    // Back to the About screen it was opened from
+    currentState = MenuState::ABOUT;
+    drawAbout();
+  } else if (currentState == MenuState::SENSOR_VALUES) {
+    // Back to the About screen it was opened from
+    currentState = MenuState::ABOUT;
+    screenImuFields = 0;
+    drawAbout();
   }
 }
 
@@ -298,46 +475,43 @@ void DisplayHandler::pressRight() {
   
   lastActivityTime = millis();
   
-  if (inlineEditMode) {
+  if (pointEditMode) {
+    // Next point; past the last one saves the curve
+    if (++pointSelection >= CURVE_POINTS) {
+      int curve = m_userSettings.getCurve((SensorChannel)subMenuSelection);
+      m_userSettings.setUserCurve(curve - USER_CURVE_FIRST, editPoints);
+      pointEditMode = false;
+    }
+    redrawCurve();
+  } else if (inlineEditMode) {
     // Save value based on menu context
     if (mainMenuSelection == 0 && menuDepth == 3) { // Sensors -> [Sensor] -> [Setting]
       // subMenuSelection 0-4 = Breath, Pinch, Expression, Tilt, Nod
       // thirdMenuSelection 0-3 = Calibration, Curve, Floor, Ceiling
       if (thirdMenuSelection == 0) { // Calibration
-        if (subMenuSelection == 0) m_userSettings.setCalBreath(editValueFloat);
-        else if (subMenuSelection == 1) m_userSettings.setCalPinch(editValueFloat);
-        else if (subMenuSelection == 2) m_userSettings.setCalExp(editValueFloat);
-        else if (subMenuSelection == 3) m_userSettings.setCalTilt(editValueFloat);
-        else if (subMenuSelection == 4) m_userSettings.setCalNod(editValueFloat);
+        m_userSettings.setCal((SensorChannel)subMenuSelection, editValueFloat);
       } else if (thirdMenuSelection == 1) { // Curve
-        if (subMenuSelection == 0) m_userSettings.setBreathCurve(editValue);
-        else if (subMenuSelection == 1) m_userSettings.setPinchCurve(editValue);
-        else if (subMenuSelection == 2) m_userSettings.setExpCurve(editValue);
-        else if (subMenuSelection == 3) m_userSettings.setTiltCurve(editValue);
-        else if (subMenuSelection == 4) m_userSettings.setNodCurve(editValue);
+        m_userSettings.setCurve((SensorChannel)subMenuSelection, editValue);
+        // A user curve goes straight on to editing its points
+        if (editValue >= USER_CURVE_FIRST) {
+          editPoints = m_userSettings.getUserCurve(editValue - USER_CURVE_FIRST);
+          pointSelection = 0;
+          pointEditMode = true;
+        }
       } else if (thirdMenuSelection == 2) { // Floor
-        if (subMenuSelection == 0) m_userSettings.setBreathFloor(editValueFloat);
-        else if (subMenuSelection == 1) m_userSettings.setPinchFloor(editValueFloat);
-        else if (subMenuSelection == 2) m_userSettings.setExpFloor(editValueFloat);
-        else if (subMenuSelection == 3) m_userSettings.setTiltFloor(editValueFloat);
-        else if (subMenuSelection == 4) m_userSettings.setNodFloor(editValueFloat);
+        m_userSettings.setFloor((SensorChannel)subMenuSelection, editValueFloat);
       } else if (thirdMenuSelection == 3) { // Ceiling
-        if (subMenuSelection == 0) m_userSettings.setBreathCeiling(editValueFloat);
-        else if (subMenuSelection == 1) m_userSettings.setPinchCeiling(editValueFloat);
-        else if (subMenuSelection == 2) m_userSettings.setExpCeiling(editValueFloat);
-        else if (subMenuSelection == 3) m_userSettings.setTiltCeiling(editValueFloat);
-        else if (subMenuSelection == 4) m_userSettings.setNodCeiling(editValueFloat);
+        m_userSettings.setCeiling((SensorChannel)subMenuSelection, editValueFloat);
       }
+    } else if (mainMenuSelection == 2 && menuDepth == 3) { // Matrix -> [Slot] -> [Setting]
+      setMatrixValue(thirdMenuSelection, editValue);
     } else if (mainMenuSelection == 1) { // MIDI
       if (subMenuSelection == 0) m_userSettings.setMidiChannel(editValue);
-      else if (subMenuSelection == 1) m_userSettings.setBreathCC(editValue);
-      else if (subMenuSelection == 2) m_userSettings.setPinchCC(editValue);
-      else if (subMenuSelection == 3) m_userSettings.setExpCC(editValue);
-      else if (subMenuSelection == 4) m_userSettings.setTiltCC(editValue);
-      else if (subMenuSelection == 5) m_userSettings.setNodCC(editValue);
+      else if (subMenuSelection >= 1 && subMenuSelection <= 5) m_userSettings.setCC((SensorChannel)(subMenuSelection - 1), editValue);
       else if (subMenuSelection == 6) m_userSettings.setUsbMidiEnabled(editValue > 0);
       else if (subMenuSelection == 7) m_userSettings.setHwMidiEnabled(editValue > 0);
-    } else if (mainMenuSelection == 2) { // Device Settings
+      else if (subMenuSelection >= 8 && subMenuSelection <= 12) m_userSettings.setResolution((SensorChannel)(subMenuSelection - 8), (CcResolution)editValue);
+    } else if (mainMenuSelection == 3) { // Device Settings
       if (subMenuSelection == 0) {
         // Map 1-10 directly to brightness levels: 1=26, 2=51, 3=77, 4=102, 5=128, 6=153, 7=179, 8=204, 9=230, 10=255
         int scaledBrightness = 26 + ((editValue - 1) * 25);
@@ -367,12 +541,27 @@ void DisplayHandler::pressRight() {
           needsFullRedraw = true;
           drawSubMenu();
         }
+      } else if (mainMenuSelection == 2) {
+        // Matrix submenu
+        if (subMenuSelection == UserSettings::MOD_SLOTS) {
+          // Reset Matrix - show confirmation
+          pendingResetType = 6;
+          currentState = MenuState::CONFIRM_DIALOG;
+          drawConfirmDialog();
+        } else {
+          // Go deeper into the slot's settings
+          menuDepth = 3;
+          thirdMenuSelection = 0;
+          thirdMenuScroll = 0;
+          needsFullRedraw = true;
+          drawSubMenu();
+        }
       } else {
         // Enter edit mode for second-level items
         editingFloat = false;
         
         if (mainMenuSelection == 1) { // MIDI
-          if (subMenuSelection == 8) {
+          if (subMenuSelection == 13) {
             // Reset MIDI - show confirmation
             pendingResetType = 3;
             currentState = MenuState::CONFIRM_DIALOG;
@@ -380,19 +569,21 @@ void DisplayHandler::pressRight() {
           } else {
             editingFloat = false;
             if (subMenuSelection == 0) editValue = m_userSettings.getMidiChannel();
-            else if (subMenuSelection == 1) editValue = m_userSettings.getBreathCC();
-            else if (subMenuSelection == 2) editValue = m_userSettings.getPinchCC();
-            else if (subMenuSelection == 3) editValue = m_userSettings.getExpCC();
-            else if (subMenuSelection == 4) editValue = m_userSettings.getTiltCC();
-            else if (subMenuSelection == 5) editValue = m_userSettings.getNodCC();
+            else if (subMenuSelection >= 1 && subMenuSelection <= 5) editValue = m_userSettings.getCC((SensorChannel)(subMenuSelection - 1));
             else if (subMenuSelection == 6) editValue = m_userSettings.getUsbMidiEnabled() ? 1 : 0;
             else if (subMenuSelection == 7) editValue = m_userSettings.getHwMidiEnabled() ? 1 : 0;
+            else if (subMenuSelection >= 8 && subMenuSelection <= 12) editValue = (int)m_userSettings.getResolution((SensorChannel)(subMenuSelection - 8));
             
             inlineEditMode = true;
             redrawEditValue();
           }
-        } else if (mainMenuSelection == 2) { // Device Settings
+        } else if (mainMenuSelection == 3) { // Device Settings
           if (subMenuSelection == 2) {
+            // Latency - live figures until Left
+            currentState = MenuState::LATENCY;
+            needsFullRedraw = true;
+            drawLatency();
+          } else if (subMenuSelection == 3) {
             // Factory Reset - show confirmation
             pendingResetType = 4;
             currentState = MenuState::CONFIRM_DIALOG;
@@ -416,6 +607,11 @@ void DisplayHandler::pressRight() {
           }
         }
       }
+    } else if (mainMenuSelection == 2) { // menuDepth == 3, matrix slot
+      editingFloat = false;
+      editValue = getMatrixValue(thirdMenuSelection);
+      inlineEditMode = true;
+      redrawEditValue();
     } else { // menuDepth == 3
       // Enter edit mode for third-level items in new sensor structure
       // subMenuSelection 0-4 = Breath, Pinch, Expression, Tilt, Nod
@@ -425,29 +621,13 @@ void DisplayHandler::pressRight() {
       
       // Load value based on sensor and setting
       if (thirdMenuSelection == 0) { // Calibration
-        if (subMenuSelection == 0) editValueFloat = m_userSettings.getCalBreath();
-        else if (subMenuSelection == 1) editValueFloat = m_userSettings.getCalPinch();
-        else if (subMenuSelection == 2) editValueFloat = m_userSettings.getCalExp();
-        else if (subMenuSelection == 3) editValueFloat = m_userSettings.getCalTilt();
-        else if (subMenuSelection == 4) editValueFloat = m_userSettings.getCalNod();
+        editValueFloat = m_userSettings.getCal((SensorChannel)subMenuSelection);
       } else if (thirdMenuSelection == 1) { // Curve (int)
-        if (subMenuSelection == 0) editValue = m_userSettings.getBreathCurve();
-        else if (subMenuSelection == 1) editValue = m_userSettings.getPinchCurve();
-        else if (subMenuSelection == 2) editValue = m_userSettings.getExpCurve();
-        else if (subMenuSelection == 3) editValue = m_userSettings.getTiltCurve();
-        else if (subMenuSelection == 4) editValue = m_userSettings.getNodCurve();
+        editValue = m_userSettings.getCurve((SensorChannel)subMenuSelection);
       } else if (thirdMenuSelection == 2) { // Floor (float)
-        if (subMenuSelection == 0) editValueFloat = m_userSettings.getBreathFloor();
-        else if (subMenuSelection == 1) editValueFloat = m_userSettings.getPinchFloor();
-        else if (subMenuSelection == 2) editValueFloat = m_userSettings.getExpFloor();
-        else if (subMenuSelection == 3) editValueFloat = m_userSettings.getTiltFloor();
-        else if (subMenuSelection == 4) editValueFloat = m_userSettings.getNodFloor();
+        editValueFloat = m_userSettings.getFloor((SensorChannel)subMenuSelection);
       } else if (thirdMenuSelection == 3) { // Ceiling (float)
-        if (subMenuSelection == 0) editValueFloat = m_userSettings.getBreathCeiling();
-        else if (subMenuSelection == 1) editValueFloat = m_userSettings.getPinchCeiling();
-        else if (subMenuSelection == 2) editValueFloat = m_userSettings.getExpCeiling();
-        else if (subMenuSelection == 3) editValueFloat = m_userSettings.getTiltCeiling();
-        else if (subMenuSelection == 4) editValueFloat = m_userSettings.getNodCeiling();
+        editValueFloat = m_userSettings.getCeiling((SensorChannel)subMenuSelection);
       }
       
       inlineEditMode = true;
@@ -455,7 +635,7 @@ void DisplayHandler::pressRight() {
     }
   } else if (currentState == MenuState::MAIN_MENU) {
     // Enter sub-menu or show about screen
-    if (mainMenuSelection == 3) {
+    if (mainMenuSelection == 4) {
       // About menu - show info screen
       currentState = MenuState::ABOUT;
       drawAbout();
@@ -471,36 +651,24 @@ void DisplayHandler::pressRight() {
     // Yes - perform reset based on type
     if (pendingResetType == 1) {
       // Reset calibration values to 1.0
-      m_userSettings.setCalBreath(1.0);
-      m_userSettings.setCalPinch(1.0);
-      m_userSettings.setCalExp(1.0);
-      m_userSettings.setCalTilt(1.0);
-      m_userSettings.setCalNod(1.0);
+      for (uint8_t i = 0; i < UserSettings::CHANNELS; i++) {
+        m_userSettings.setCal((SensorChannel)i, 1.0);
+      }
     } else if (pendingResetType == 2) {
       // Reset curves and floor/ceiling to defaults
-      m_userSettings.setBreathCurve(1);
-      m_userSettings.setBreathFloor(0.0);
-      m_userSettings.setBreathCeiling(1.0);
-      m_userSettings.setPinchCurve(1);
-      m_userSettings.setPinchFloor(0.0);
-      m_userSettings.setPinchCeiling(1.0);
-      m_userSettings.setExpCurve(1);
-      m_userSettings.setExpFloor(0.0);
-      m_userSettings.setExpCeiling(1.0);
-      m_userSettings.setTiltCurve(1);
-      m_userSettings.setTiltFloor(0.0);
-      m_userSettings.setTiltCeiling(1.0);
-      m_userSettings.setNodCurve(1);
-      m_userSettings.setNodFloor(0.0);
-      m_userSettings.setNodCeiling(1.0);
+      for (uint8_t i = 0; i < UserSettings::CHANNELS; i++) {
+        m_userSettings.setCurve((SensorChannel)i, 1);
+        m_userSettings.setFloor((SensorChannel)i, 0.0);
+        m_userSettings.setCeiling((SensorChannel)i, 1.0);
+      }
+      m_userSettings.resetUserCurves();
     } else if (pendingResetType == 3) {
       // Reset MIDI settings
       m_userSettings.setMidiChannel(1);
-      m_userSettings.setBreathCC(1);
-      m_userSettings.setPinchCC(2);
-      m_userSettings.setExpCC(3);
-      m_userSettings.setTiltCC(4);
-      m_userSettings.setNodCC(5);
+      for (uint8_t i = 0; i < UserSettings::CHANNELS; i++) {
+        m_userSettings.setCC((SensorChannel)i, i + 1);
+        m_userSettings.setResolution((SensorChannel)i, CcResolution::STANDARD);
+      }
       m_userSettings.setUsbMidiEnabled(true);
       m_userSettings.setHwMidiEnabled(true);
     } else if (pendingResetType == 4) {
@@ -508,31 +676,33 @@ void DisplayHandler::pressRight() {
       m_userSettings.resetToDefaults();
     } else if (pendingResetType == 5) {
       // Reset all sensor settings (1=linear)
-      m_userSettings.setCalBreath(1.0);
-      m_userSettings.setCalPinch(1.0);
-      m_userSettings.setCalExp(1.0);
-      m_userSettings.setCalTilt(1.0);
-      m_userSettings.setCalNod(1.0);
-      m_userSettings.setBreathCurve(1);
-      m_userSettings.setPinchCurve(1);
-      m_userSettings.setExpCurve(1);
-      m_userSettings.setTiltCurve(1);
-      m_userSettings.setNodCurve(1);
-      m_userSettings.setBreathFloor(0.0);
-      m_userSettings.setBreathCeiling(1.0);
-      m_userSettings.setPinchFloor(0.0);
-      m_userSettings.setPinchCeiling(1.0);
-      m_userSettings.setExpFloor(0.0);
-      m_userSettings.setExpCeiling(1.0);
-      m_userSettings.setTiltFloor(0.0);
-      m_userSettings.setTiltCeiling(1.0);
-      m_userSettings.setNodFloor(0.0);
-      m_userSettings.setNodCeiling(1.0);
+      for (uint8_t i = 0; i < UserSettings::CHANNELS; i++) {
+        m_userSettings.setCal((SensorChannel)i, 1.0);
+        m_userSettings.setCurve((SensorChannel)i, 1);
+        m_userSettings.setFloor((SensorChannel)i, 0.0);
+        m_userSettings.setCeiling((SensorChannel)i, 1.0);
+      }
+    } else if (pendingResetType == 6) {
+      // Clear the user matrix routes
+      m_userSettings.resetModSlots();
     }
     pendingResetType = 0;
     currentState = MenuState::SUB_MENU;
     needsFullRedraw = true;
     drawSubMenu();
+  } else if (currentState == MenuState::LATENCY) {
+    // Start a new measurement
+    if (resetLatency) resetLatency();
+    drawLatency();
+  } else if (currentState == MenuState::ABOUT) {
+    // Hidden profiler screen
+    currentState = MenuState::PROFILE;
+    needsFullRedraw = true;
+    drawProfile();
+  } else if (currentState == MenuState::PROFILE) {
+    // Clear peaks and overruns
+    if (resetProfile) resetProfile();
+    drawProfile();
   }
 }
 
@@ -540,6 +710,7 @@ void DisplayHandler::changeMenuState(MenuState newState) {
   currentState = newState;
   stateStartTime = millis();
   needsFullRedraw = true;
+  screenImuFields = 0;
   
   switch(newState) {
     case MenuState::LOADING:
@@ -562,6 +733,16 @@ void DisplayHandler::changeMenuState(MenuState newState) {
     case MenuState::ABOUT:
       drawAbout();
       break;
+    case MenuState::LATENCY:
+      drawLatency();
+      break;
+    case MenuState::PROFILE:
+      drawProfile();
+      break;
+    case MenuState::SENSOR_VALUES:
+      screenImuFields = IMU_ALL;
+      drawSensorValues();
+      break;
   }
 }
 
@@ -638,7 +819,11 @@ void DisplayHandler::drawSubMenu() {
         items = midiSubMenu;
         itemCount = midiSubMenuCount;
         break;
-      case 2: // Device Settings
+      case 2: // Matrix
+        items = matrixSubMenu;
+        itemCount = matrixSubMenuCount;
+        break;
+      case 3: // Device Settings
         items = deviceSettingsSubMenu;
         itemCount = deviceSettingsSubMenuCount;
         break;
@@ -647,9 +832,14 @@ void DisplayHandler::drawSubMenu() {
     }
   } else { // menuDepth == 3
     currentSelection = thirdMenuSelection;
-    // New sensor structure: all sensors use the same detail menu
-    items = sensorDetailMenu;
-    itemCount = sensorDetailMenuCount;
+    // All sensors use the same detail menu, all matrix slots theirs
+    if (mainMenuSelection == 2) {
+      items = matrixSlotMenu;
+      itemCount = matrixSlotMenuCount;
+    } else {
+      items = sensorDetailMenu;
+      itemCount = sensorDetailMenuCount;
+    }
   }
   
   if (items == nullptr || itemCount == 0) {
@@ -683,7 +873,7 @@ void DisplayHandler::drawSubMenu() {
     if (menuDepth == 3) {
       tft.print(mainMenuItems[mainMenuSelection]);
       tft.print(" > ");
-      tft.println(sensorsSubMenu[subMenuSelection]);
+      tft.println(mainMenuSelection == 2 ? matrixSubMenu[subMenuSelection] : sensorsSubMenu[subMenuSelection]);
     } else {
       tft.println(mainMenuItems[mainMenuSelection]);
     }
@@ -717,50 +907,40 @@ void DisplayHandler::drawSubMenu() {
             tft.setCursor(320 - rightMargin - (String(val).length() * 12), y);
             tft.print(val);
           }
-          else if (itemIndex == 1) { 
-            int val = isEditing ? editValue : m_userSettings.getBreathCC();
-            if (isEditing) tft.setTextColor(COLOR_ACCENT);
-            tft.setCursor(320 - rightMargin - (String(val).length() * 12), y);
-            tft.print(val);
-          }
-          else if (itemIndex == 2) { 
-            int val = isEditing ? editValue : m_userSettings.getPinchCC();
-            if (isEditing) tft.setTextColor(COLOR_ACCENT);
-            tft.setCursor(320 - rightMargin - (String(val).length() * 12), y);
-            tft.print(val);
-          }
-          else if (itemIndex == 3) { 
-            int val = isEditing ? editValue : m_userSettings.getExpCC();
+          else if (itemIndex >= 1 && itemIndex <= 5) { 
+            int val = isEditing ? editValue : m_userSettings.getCC((SensorChannel)(itemIndex - 1));
             if (isEditing) tft.setTextColor(COLOR_ACCENT);
             tft.setCursor(320 - rightMargin - (String(val).length() * 12), y);
             tft.print(val);
           }
-          else if (itemIndex == 4) { 
-            int val = isEditing ? editValue : m_userSettings.getTiltCC();
+          else if (itemIndex == 6) { 
+            const char* val = (isEditing ? editValue : m_userSettings.getUsbMidiEnabled()) ? "ON" : "OFF";
             if (isEditing) tft.setTextColor(COLOR_ACCENT);
-            tft.setCursor(320 - rightMargin - (String(val).length() * 12), y);
+            tft.setCursor(320 - rightMargin - (strlen(val) * 12), y);
             tft.print(val);
           }
-          else if (itemIndex == 5) { 
-            int val = isEditing ? editValue : m_userSettings.getNodCC();
+          else if (itemIndex == 7) { 
+            const char* val = (isEditing ? editValue : m_userSettings.getHwMidiEnabled()) ? "ON" : "OFF";
             if (isEditing) tft.setTextColor(COLOR_ACCENT);
-            tft.setCursor(320 - rightMargin - (String(val).length() * 12), y);
+            tft.setCursor(320 - rightMargin - (strlen(val) * 12), y);
             tft.print(val);
           }
-          else if (itemIndex == 6) { 
-            const char* val = (isEditing ? editValue : m_userSettings.getUsbMidiEnabled()) ? "ON" : "OFF";
+          else if (itemIndex >= 8 && itemIndex <= 12) { 
+            int mode = isEditing ? editValue : (int)m_userSettings.getResolution((SensorChannel)(itemIndex - 8));
+            const char* val = resolutionNames[mode];
             if (isEditing) tft.setTextColor(COLOR_ACCENT);
             tft.setCursor(320 - rightMargin - (strlen(val) * 12), y);
             tft.print(val);
           }
-          else if (itemIndex == 7) { 
-            const char* val = (isEditing ? editValue : m_userSettings.getHwMidiEnabled()) ? "ON" : "OFF";
-            if (isEditing) tft.setTextColor(COLOR_ACCENT);
+          // itemIndex 13 is "Reset MIDI" - no value to display
+        } else if (mainMenuSelection == 2) { // Matrix
+          if (itemIndex < UserSettings::MOD_SLOTS) {
+            const char* val = modDestinationNames[(int)m_userSettings.getModSlot(itemIndex).destination];
             tft.setCursor(320 - rightMargin - (strlen(val) * 12), y);
             tft.print(val);
           }
-          // itemIndex 8 is "Reset MIDI" - no value to display
-        } else if (mainMenuSelection == 2) { // Device Settings
+          // Last item is "Reset Matrix" - no value to display
+        } else if (mainMenuSelection == 3) { // Device Settings
           if (itemIndex == 0) { 
             int brightness = m_userSettings.getDisplayBrightness();
             int displayVal;
@@ -779,20 +959,20 @@ void DisplayHandler::drawSubMenu() {
             tft.setCursor(320 - rightMargin - (valStr.length() * 12), y);
             tft.print(valStr);
           }
-          // itemIndex 2 is "Factory Reset" - no value to display
+          // itemIndex 2 is "Latency" (a screen), 3 is "Factory Reset" - no value to display
         }
+      } else if (mainMenuSelection == 2) { // menuDepth == 3, matrix slot
+        String valStr = matrixValueText(itemIndex, isEditing ? editValue : getMatrixValue(itemIndex));
+        if (isEditing) tft.setTextColor(COLOR_ACCENT);
+        tft.setCursor(320 - rightMargin - (valStr.length() * 12), y);
+        tft.print(valStr);
       } else { // menuDepth == 3
         // New sensor-based structure
         // subMenuSelection 0-4 = Breath, Pinch, Expression, Tilt, Nod
         // thirdMenuSelection/itemIndex 0-3 = Calibration, Curve, Floor, Ceiling
         
         if (itemIndex == 0) { // Calibration
-          float val = 0.0;
-          if (subMenuSelection == 0) val = m_userSettings.getCalBreath();
-          else if (subMenuSelection == 1) val = m_userSettings.getCalPinch();
-          else if (subMenuSelection == 2) val = m_userSettings.getCalExp();
-          else if (subMenuSelection == 3) val = m_userSettings.getCalTilt();
-          else if (subMenuSelection == 4) val = m_userSettings.getCalNod();
+          float val = m_userSettings.getCal((SensorChannel)subMenuSelection);
           if (isEditing) {
             val = editValueFloat;
             tft.setTextColor(COLOR_ACCENT);
@@ -801,26 +981,17 @@ void DisplayHandler::drawSubMenu() {
           tft.print(val, 2);
         }
         else if (itemIndex == 1) { // Curve
-          int val = 0;
-          if (subMenuSelection == 0) val = m_userSettings.getBreathCurve();
-          else if (subMenuSelection == 1) val = m_userSettings.getPinchCurve();
-          else if (subMenuSelection == 2) val = m_userSettings.getExpCurve();
-          else if (subMenuSelection == 3) val = m_userSettings.getTiltCurve();
-          else if (subMenuSelection == 4) val = m_userSettings.getNodCurve();
+          int val = m_userSettings.getCurve((SensorChannel)subMenuSelection);
           if (isEditing) {
             val = editValue;
             tft.setTextColor(COLOR_ACCENT);
           }
-          tft.setCursor(320 - rightMargin - (String(val).length() * 12), y);
-          tft.print(val);
+          String valStr = curveText(val);
+          tft.setCursor(320 - rightMargin - (valStr.length() * 12), y);
+          tft.print(valStr);
         }
         else if (itemIndex == 2) { // Floor
-          float val = 0.0;
-          if (subMenuSelection == 0) val = m_userSettings.getBreathFloor();
-          else if (subMenuSelection == 1) val = m_userSettings.getPinchFloor();
-          else if (subMenuSelection == 2) val = m_userSettings.getExpFloor();
-          else if (subMenuSelection == 3) val = m_userSettings.getTiltFloor();
-          else if (subMenuSelection == 4) val = m_userSettings.getNodFloor();
+          float val = m_userSettings.getFloor((SensorChannel)subMenuSelection);
           if (isEditing) {
             val = editValueFloat;
             tft.setTextColor(COLOR_ACCENT);
@@ -829,12 +1000,7 @@ void DisplayHandler::drawSubMenu() {
           tft.print(val, 2);
         }
         else if (itemIndex == 3) { // Ceiling
-          float val = 0.0;
-          if (subMenuSelection == 0) val = m_userSettings.getBreathCeiling();
-          else if (subMenuSelection == 1) val = m_userSettings.getPinchCeiling();
-          else if (subMenuSelection == 2) val = m_userSettings.getExpCeiling();
-          else if (subMenuSelection == 3) val = m_userSettings.getTiltCeiling();
-          else if (subMenuSelection == 4) val = m_userSettings.getNodCeiling();
+          float val = m_userSettings.getCeiling((SensorChannel)subMenuSelection);
           if (isEditing) {
             val = editValueFloat;
             tft.setTextColor(COLOR_ACCENT);
@@ -888,14 +1054,11 @@ void DisplayHandler::drawSubMenu() {
         if (menuDepth == 2) {
           if (mainMenuSelection == 1) {
             if (prevSelection == 0) { int val = m_userSettings.getMidiChannel(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
-            else if (prevSelection == 1) { int val = m_userSettings.getBreathCC(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
-            else if (prevSelection == 2) { int val = m_userSettings.getPinchCC(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
-            else if (prevSelection == 3) { int val = m_userSettings.getExpCC(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
-            else if (prevSelection == 4) { int val = m_userSettings.getTiltCC(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
-            else if (prevSelection == 5) { int val = m_userSettings.getNodCC(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
+            else if (prevSelection >= 1 && prevSelection <= 5) { int val = m_userSettings.getCC((SensorChannel)(prevSelection - 1)); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
             else if (prevSelection == 6) { const char* val = m_userSettings.getUsbMidiEnabled() ? "ON" : "OFF"; tft.setCursor(320 - rightMargin - (strlen(val) * 12), y); tft.print(val); }
             else if (prevSelection == 7) { const char* val = m_userSettings.getHwMidiEnabled() ? "ON" : "OFF"; tft.setCursor(320 - rightMargin - (strlen(val) * 12), y); tft.print(val); }
-          } else if (mainMenuSelection == 2) {
+            else if (prevSelection >= 8 && prevSelection <= 12) { const char* val = resolutionNames[(int)m_userSettings.getResolution((SensorChannel)(prevSelection - 8))]; tft.setCursor(320 - rightMargin - (strlen(val) * 12), y); tft.print(val); }
+          } else if (mainMenuSelection == 3) {
             if (prevSelection == 0) { 
               int brightness = m_userSettings.getDisplayBrightness();
               int val;
@@ -906,47 +1069,35 @@ void DisplayHandler::drawSubMenu() {
               tft.print(val); 
             }
             else if (prevSelection == 1) { int val = m_userSettings.getScreenSleep(); String valStr = String(val) + "s"; tft.setCursor(320 - rightMargin - (valStr.length() * 12), y); tft.print(valStr); }
-            // prevSelection == 2 is Factory Reset - no value to display
+            // prevSelection 2 and 3 are Latency and Factory Reset - no value to display
+          } else if (mainMenuSelection == 2 && prevSelection < UserSettings::MOD_SLOTS) {
+            const char* val = modDestinationNames[(int)m_userSettings.getModSlot(prevSelection).destination];
+            tft.setCursor(320 - rightMargin - (strlen(val) * 12), y);
+            tft.print(val);
           }
+        } else if (mainMenuSelection == 2) {
+          String valStr = matrixValueText(prevSelection, getMatrixValue(prevSelection));
+          tft.setCursor(320 - rightMargin - (valStr.length() * 12), y);
+          tft.print(valStr);
         } else {
           // New sensor structure: prevSelection 0-3 = Calibration, Curve, Floor, Ceiling
           if (prevSelection == 0) { // Calibration
-            float val = 0.0;
-            if (subMenuSelection == 0) val = m_userSettings.getCalBreath();
-            else if (subMenuSelection == 1) val = m_userSettings.getCalPinch();
-            else if (subMenuSelection == 2) val = m_userSettings.getCalExp();
-            else if (subMenuSelection == 3) val = m_userSettings.getCalTilt();
-            else if (subMenuSelection == 4) val = m_userSettings.getCalNod();
+            float val = m_userSettings.getCal((SensorChannel)subMenuSelection);
             tft.setCursor(320 - rightMargin - (String(val, 2).length() * 12), y);
             tft.print(val, 2);
           }
           else if (prevSelection == 1) { // Curve
-            int val = 0;
-            if (subMenuSelection == 0) val = m_userSettings.getBreathCurve();
-            else if (subMenuSelection == 1) val = m_userSettings.getPinchCurve();
-            else if (subMenuSelection == 2) val = m_userSettings.getExpCurve();
-            else if (subMenuSelection == 3) val = m_userSettings.getTiltCurve();
-            else if (subMenuSelection == 4) val = m_userSettings.getNodCurve();
-            tft.setCursor(320 - rightMargin - (String(val).length() * 12), y);
-            tft.print(val);
+            String valStr = curveText(m_userSettings.getCurve((SensorChannel)subMenuSelection));
+            tft.setCursor(320 - rightMargin - (valStr.length() * 12), y);
+            tft.print(valStr);
           }
           else if (prevSelection == 2) { // Floor
-            float val = 0.0;
-            if (subMenuSelection == 0) val = m_userSettings.getBreathFloor();
-            else if (subMenuSelection == 1) val = m_userSettings.getPinchFloor();
-            else if (subMenuSelection == 2) val = m_userSettings.getExpFloor();
-            else if (subMenuSelection == 3) val = m_userSettings.getTiltFloor();
-            else if (subMenuSelection == 4) val = m_userSettings.getNodFloor();
+            float val = m_userSettings.getFloor((SensorChannel)subMenuSelection);
             tft.setCursor(320 - rightMargin - (String(val, 2).length() * 12), y);
             tft.print(val, 2);
           }
           else if (prevSelection == 3) { // Ceiling
-            float val = 0.0;
-            if (subMenuSelection == 0) val = m_userSettings.getBreathCeiling();
-            else if (subMenuSelection == 1) val = m_userSettings.getPinchCeiling();
-            else if (subMenuSelection == 2) val = m_userSettings.getExpCeiling();
-            else if (subMenuSelection == 3) val = m_userSettings.getTiltCeiling();
-            else if (subMenuSelection == 4) val = m_userSettings.getNodCeiling();
+            float val = m_userSettings.getCeiling((SensorChannel)subMenuSelection);
             tft.setCursor(320 - rightMargin - (String(val, 2).length() * 12), y);
             tft.print(val, 2);
           }
@@ -966,14 +1117,11 @@ void DisplayHandler::drawSubMenu() {
         if (menuDepth == 2) {
           if (mainMenuSelection == 1) {
             if (currentSelection == 0) { int val = m_userSettings.getMidiChannel(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
-            else if (currentSelection == 1) { int val = m_userSettings.getBreathCC(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
-            else if (currentSelection == 2) { int val = m_userSettings.getPinchCC(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
-            else if (currentSelection == 3) { int val = m_userSettings.getExpCC(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
-            else if (currentSelection == 4) { int val = m_userSettings.getTiltCC(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
-            else if (currentSelection == 5) { int val = m_userSettings.getNodCC(); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
+            else if (currentSelection >= 1 && currentSelection <= 5) { int val = m_userSettings.getCC((SensorChannel)(currentSelection - 1)); tft.setCursor(320 - rightMargin - (String(val).length() * 12), y); tft.print(val); }
             else if (currentSelection == 6) { const char* val = m_userSettings.getUsbMidiEnabled() ? "ON" : "OFF"; tft.setCursor(320 - rightMargin - (strlen(val) * 12), y); tft.print(val); }
             else if (currentSelection == 7) { const char* val = m_userSettings.getHwMidiEnabled() ? "ON" : "OFF"; tft.setCursor(320 - rightMargin - (strlen(val) * 12), y); tft.print(val); }
-          } else if (mainMenuSelection == 2) {
+            else if (currentSelection >= 8 && currentSelection <= 12) { const char* val = resolutionNames[(int)m_userSettings.getResolution((SensorChannel)(currentSelection - 8))]; tft.setCursor(320 - rightMargin - (strlen(val) * 12), y); tft.print(val); }
+          } else if (mainMenuSelection == 3) {
             if (currentSelection == 0) { 
               int brightness = m_userSettings.getDisplayBrightness();
               int val;
@@ -984,47 +1132,35 @@ void DisplayHandler::drawSubMenu() {
               tft.print(val); 
             }
             else if (currentSelection == 1) { int val = m_userSettings.getScreenSleep(); String valStr = String(val) + "s"; tft.setCursor(320 - rightMargin - (valStr.length() * 12), y); tft.print(valStr); }
-            // currentSelection == 2 is Factory Reset - no value to display
+            // currentSelection 2 and 3 are Latency and Factory Reset - no value to display
+          } else if (mainMenuSelection == 2 && currentSelection < UserSettings::MOD_SLOTS) {
+            const char* val = modDestinationNames[(int)m_userSettings.getModSlot(currentSelection).destination];
+            tft.setCursor(320 - rightMargin - (strlen(val) * 12), y);
+            tft.print(val);
           }
+        } else if (mainMenuSelection == 2) {
+          String valStr = matrixValueText(currentSelection, getMatrixValue(currentSelection));
+          tft.setCursor(320 - rightMargin - (valStr.length() * 12), y);
+          tft.print(valStr);
         } else {
           // New sensor structure: currentSelection 0-3 = Calibration, Curve, Floor, Ceiling
           if (currentSelection == 0) { // Calibration
-            float val = 0.0;
-            if (subMenuSelection == 0) val = m_userSettings.getCalBreath();
-            else if (subMenuSelection == 1) val = m_userSettings.getCalPinch();
-            else if (subMenuSelection == 2) val = m_userSettings.getCalExp();
-            else if (subMenuSelection == 3) val = m_userSettings.getCalTilt();
-            else if (subMenuSelection == 4) val = m_userSettings.getCalNod();
+            float val = m_userSettings.getCal((SensorChannel)subMenuSelection);
             tft.setCursor(320 - rightMargin - (String(val, 2).length() * 12), y);
             tft.print(val, 2);
           }
           else if (currentSelection == 1) { // Curve
-            int val = 0;
-            if (subMenuSelection == 0) val = m_userSettings.getBreathCurve();
-            else if (subMenuSelection == 1) val = m_userSettings.getPinchCurve();
-            else if (subMenuSelection == 2) val = m_userSettings.getExpCurve();
-            else if (subMenuSelection == 3) val = m_userSettings.getTiltCurve();
-            else if (subMenuSelection == 4) val = m_userSettings.getNodCurve();
-            tft.setCursor(320 - rightMargin - (String(val).length() * 12), y);
-            tft.print(val);
+            String valStr = curveText(m_userSettings.getCurve((SensorChannel)subMenuSelection));
+            tft.setCursor(320 - rightMargin - (valStr.length() * 12), y);
+            tft.print(valStr);
           }
           else if (currentSelection == 2) { // Floor
-            float val = 0.0;
-            if (subMenuSelection == 0) val = m_userSettings.getBreathFloor();
-            else if (subMenuSelection == 1) val = m_userSettings.getPinchFloor();
-            else if (subMenuSelection == 2) val = m_userSettings.getExpFloor();
-            else if (subMenuSelection == 3) val = m_userSettings.getTiltFloor();
-            else if (subMenuSelection == 4) val = m_userSettings.getNodFloor();
+            float val = m_userSettings.getFloor((SensorChannel)subMenuSelection);
             tft.setCursor(320 - rightMargin - (String(val, 2).length() * 12), y);
             tft.print(val, 2);
           }
           else if (currentSelection == 3) { // Ceiling
-            float val = 0.0;
-            if (subMenuSelection == 0) val = m_userSettings.getBreathCeiling();
-            else if (subMenuSelection == 1) val = m_userSettings.getPinchCeiling();
-            else if (subMenuSelection == 2) val = m_userSettings.getExpCeiling();
-            else if (subMenuSelection == 3) val = m_userSettings.getTiltCeiling();
-            else if (subMenuSelection == 4) val = m_userSettings.getNodCeiling();
+            float val = m_userSettings.getCeiling((SensorChannel)subMenuSelection);
             tft.setCursor(320 - rightMargin - (String(val, 2).length() * 12), y);
             tft.print(val, 2);
           }
@@ -1040,50 +1176,87 @@ void DisplayHandler::drawSubMenu() {
   }
 }
 
-void DisplayHandler::drawResponseCurve() {
-  // Only draw curve on sensor detail menu (depth 3)
-  if (menuDepth != 3 || mainMenuSelection != 0) return;
+SignalChain::Response DisplayHandler::previewResponse() {
+  // Current settings for the selected sensor, overridden by the value being edited
+  SensorChannel sensor = (SensorChannel)subMenuSelection;
+  int curve = m_userSettings.getCurve(sensor);
+  float floor = m_userSettings.getFloor(sensor);
+  float ceiling = m_userSettings.getCeiling(sensor);
   
-  // Get current settings for selected sensor
-  int curve = 1;
-  float floor = 0.0;
-  float ceiling = 1.0;
-  
-  if (subMenuSelection == 0) { // Breath
-    curve = m_userSettings.getBreathCurve();
-    floor = m_userSettings.getBreathFloor();
-    ceiling = m_userSettings.getBreathCeiling();
-  } else if (subMenuSelection == 1) { // Pinch
-    curve = m_userSettings.getPinchCurve();
-    floor = m_userSettings.getPinchFloor();
-    ceiling = m_userSettings.getPinchCeiling();
-  } else if (subMenuSelection == 2) { // Expression
-    curve = m_userSettings.getExpCurve();
-    floor = m_userSettings.getExpFloor();
-    ceiling = m_userSettings.getExpCeiling();
-  } else if (subMenuSelection == 3) { // Tilt
-    curve = m_userSettings.getTiltCurve();
-    floor = m_userSettings.getTiltFloor();
-    ceiling = m_userSettings.getTiltCeiling();
-  } else if (subMenuSelection == 4) { // Nod
-    curve = m_userSettings.getNodCurve();
-    floor = m_userSettings.getNodFloor();
-    ceiling = m_userSettings.getNodCeiling();
+  if (inlineEditMode) {
+    if (thirdMenuSelection == 1) curve = editValue;
+    else if (thirdMenuSelection == 2) floor = editValueFloat;
+    else if (thirdMenuSelection == 3) ceiling = editValueFloat;
   }
   
-  // Override with edit values if currently editing
-  if (inlineEditMode) {
-    if (thirdMenuSelection == 0) { // Calibration (doesn't affect curve shape)
-      // No override needed
-    } else if (thirdMenuSelection == 1) { // Curve
-      curve = editValue;
-    } else if (thirdMenuSelection == 2) { // Floor
-      floor = editValueFloat;
-    } else if (thirdMenuSelection == 3) { // Ceiling
-      ceiling = editValueFloat;
+  // User curves preview the points being moved, or the saved ones
+  if (curve >= USER_CURVE_FIRST) {
+    previewSpline.setPoints(pointEditMode ? editPoints : m_userSettings.getUserCurve(curve - USER_CURVE_FIRST));
+  }
+  return SignalChain::response(curve, floor, ceiling, &previewSpline);
+}
+
+String DisplayHandler::curveText(int curve) {
+  if (curve >= USER_CURVE_FIRST) return "User " + String(curve - USER_CURVE_FIRST + 1);
+  return String(curve);
+}
+
+void DisplayHandler::adjustCurvePoint(int delta) {
+  // A point stays between its neighbours, so the curve never falls
+  int low = pointSelection > 0 ? editPoints.level[pointSelection - 1] : 0;
+  int high = pointSelection < CURVE_POINTS - 1 ? editPoints.level[pointSelection + 1] : 255;
+  CurvePoints moved = editPoints;
+  moved.level[pointSelection] = constrain(editPoints.level[pointSelection] + delta, low, high);
+  // and it never goes completely flat
+  if (!moved.isValid()) return;
+  editPoints = moved;
+  redrawCurve();
+}
+
+void DisplayHandler::redrawCurve() {
+  // Clear curve area and the point label under it
+  tft.fillRect(15, 145, 290, 86, COLOR_BACKGROUND);
+  tft.fillRect(15, 232, 120, 10, COLOR_BACKGROUND);
+  drawResponseCurve();
+  // Force sensor indicator update on next cycle
+  prevSensorValue = -1.0;
+}
+
+void DisplayHandler::drawCurvePoints() {
+  // Graph dimensions (must match drawResponseCurve)
+  const int graphX = 20;
+  const int graphY = 150;
+  const int graphWidth = 280;
+  const int graphHeight = 80;
+  const int graphBottom = graphY + graphHeight;
+  
+  for (int i = 0; i < CURVE_POINTS; i++) {
+    int x = graphX + i * graphWidth / (CURVE_POINTS - 1);
+    int y = graphBottom - editPoints.level[i] * graphHeight / 255;
+    if (i == pointSelection) {
+      tft.fillRect(x - 3, y - 3, 7, 7, ILI9341_GREEN);
+    } else {
+      tft.drawRect(x - 2, y - 2, 5, 5, COLOR_MENU_TEXT);
     }
   }
   
+  tft.setTextSize(1);
+  tft.setTextColor(ILI9341_GREEN);
+  tft.setCursor(20, graphBottom + 2);
+  tft.print("Point ");
+  tft.print(pointSelection + 1);
+  tft.print("/");
+  tft.print(CURVE_POINTS);
+  tft.setTextSize(2);
+}
+
+void DisplayHandler::drawResponseCurve() {
+  // Only draw curve on sensor detail menu (depth 3)
+  if (menuDepth != 3 || mainMenuSelection != 0) return;
+  
+  // Same stages the MIDI output is built from
+  const SignalChain::Response response = previewResponse();
+  
   // Curve drawing parameters
   const int graphX = 20;
   const int graphY = 150;
@@ -1097,40 +1270,11 @@ void DisplayHandler::drawResponseCurve() {
   tft.drawLine(graphX, graphBottom, graphRight, graphBottom, COLOR_HEADER_LINE); // Bottom X axis
   tft.drawLine(graphX, graphY, graphX, graphBottom, COLOR_HEADER_LINE); // Y axis
   
-  // Draw curve - 4 types: 1=linear, 2=concave, 3=convex, 4=s-curve
   int prevY = -1;
   
   for (int x = 0; x <= graphWidth; x++) {
-    // Normalize screen x to 0-1 (full input range)
-    float inputNorm = (float)x / graphWidth;
-    
-    float outputNorm;
-    if (inputNorm < floor) {
-      // Below floor: output is 0
-      outputNorm = 0.0;
-    } else if (inputNorm > ceiling) {
-      // Above ceiling: output is 1
-      outputNorm = 1.0;
-    } else {
-      // Within floor-ceiling range: map to 0-1 and apply curve
-      float mappedInput = (inputNorm - floor) / (ceiling - floor);
-      
-      if (curve == 1) {
-        // Linear
-        outputNorm = mappedInput;
-      } else if (curve == 2) {
-        // Concave (ease-in)
-        outputNorm = pow(mappedInput, 2.0);
-      } else if (curve == 3) {
-        // Convex (ease-out)
-        outputNorm = pow(mappedInput, 0.5);
-      } else {
-        // S-curve (ease-in-out)
-        outputNorm = mappedInput * mappedInput * (3.0 - 2.0 * mappedInput);
-      }
-    }
-    
-    // Convert to screen Y coordinate
+    // Normalize screen x to 0-1 (full input range) and convert to screen Y
+    float outputNorm = response((float)x / graphWidth);
     int y = graphBottom - (int)(outputNorm * graphHeight);
     
     // Draw line from previous point
@@ -1139,37 +1283,20 @@ void DisplayHandler::drawResponseCurve() {
     }
     prevY = y;
   }
+  
+  if (pointEditMode) {
+    drawCurvePoints();
+  }
 }
 
 void DisplayHandler::updateCurveSensorIndicator() {
-  // Get current sensor reading and apply calibration (same math as main.cpp)
-  float sensorValue = 0.0;
-  if (subMenuSelection == 0) {
-    sensorValue = m_sensorCache.getBreathNormalized() * m_userSettings.getCalBreath();
-  } else if (subMenuSelection == 1) {
-    sensorValue = m_sensorCache.getPinchNormalized() * m_userSettings.getCalPinch();
-  } else if (subMenuSelection == 2) {
-    sensorValue = m_sensorCache.getExpressionNormalized() * m_userSettings.getCalExp();
-  } else if (subMenuSelection == 3) {
-    sensorValue = m_sensorCache.getGyroX() * m_userSettings.getCalTilt();
-  } else if (subMenuSelection == 4) {
-    sensorValue = m_sensorCache.getGyroY() * m_userSettings.getCalNod();
-  }
-  
-  // Apply calibration override if currently editing calibration
-  if (inlineEditMode && thirdMenuSelection == 0) {
-    // Use the edit value for calibration instead
-    float rawValue = 0.0;
-    if (subMenuSelection == 0) rawValue = m_sensorCache.getBreathNormalized();
-    else if (subMenuSelection == 1) rawValue = m_sensorCache.getPinchNormalized();
-    else if (subMenuSelection == 2) rawValue = m_sensorCache.getExpressionNormalized();
-    else if (subMenuSelection == 3) rawValue = m_sensorCache.getGyroX();
-    else if (subMenuSelection == 4) rawValue = m_sensorCache.getGyroY();
-    sensorValue = rawValue * editValueFloat;
-  }
-  
-  // Constrain to 0-1 range
-  sensorValue = constrain(sensorValue, 0.0, 1.0);
+  // Current sensor reading through the same source and calibration stages as main.cpp,
+  // using the edit value for calibration while it is being edited
+  SensorSnapshot frame = m_sensorCache.getSnapshot();
+  float calibration = (inlineEditMode && thirdMenuSelection == 0)
+                    ? editValueFloat : m_userSettings.getCal((SensorChannel)subMenuSelection);
+  const auto input = SignalChain::makeChain(SignalChain::Calibrate{calibration}, SignalChain::Clamp());
+  float sensorValue = input(SignalChain::readSource(frame, (ModSource)subMenuSelection));
   
   // Graph dimensions (must match drawResponseCurve)
   const int graphX = 20;
@@ -1186,39 +1313,7 @@ void DisplayHandler::updateCurveSensorIndicator() {
   if (abs(currentX - prevX) >= 1 || prevSensorValue < 0) {
     // Clear previous indicator line by redrawing what was underneath
     if (prevSensorValue >= 0.0 && prevSensorValue <= 1.0) {
-      // Get settings first (needed for both cleanup and marker overlap check)
-      int curveVal = 1;
-      float floorVal = 0.0;
-      float ceilingVal = 1.0;
-      
-      if (subMenuSelection == 0) {
-        curveVal = m_userSettings.getBreathCurve();
-        floorVal = m_userSettings.getBreathFloor();
-        ceilingVal = m_userSettings.getBreathCeiling();
-      } else if (subMenuSelection == 1) {
-        curveVal = m_userSettings.getPinchCurve();
-        floorVal = m_userSettings.getPinchFloor();
-        ceilingVal = m_userSettings.getPinchCeiling();
-      } else if (subMenuSelection == 2) {
-        curveVal = m_userSettings.getExpCurve();
-        floorVal = m_userSettings.getExpFloor();
-        ceilingVal = m_userSettings.getExpCeiling();
-      } else if (subMenuSelection == 3) {
-        curveVal = m_userSettings.getTiltCurve();
-        floorVal = m_userSettings.getTiltFloor();
-        ceilingVal = m_userSettings.getTiltCeiling();
-      } else if (subMenuSelection == 4) {
-        curveVal = m_userSettings.getNodCurve();
-        floorVal = m_userSettings.getNodFloor();
-        ceilingVal = m_userSettings.getNodCeiling();
-      }
-      
-      // Override with edit values if editing
-      if (inlineEditMode) {
-        if (thirdMenuSelection == 1) curveVal = editValue;
-        else if (thirdMenuSelection == 2) floorVal = editValueFloat;
-        else if (thirdMenuSelection == 3) ceilingVal = editValueFloat;
-      }
+      const SignalChain::Response response = previewResponse();
       
       // Erase old green line by clearing to background, then redraw what should be there
       // First pass: clear everything to background
@@ -1236,49 +1331,11 @@ void DisplayHandler::updateCurveSensorIndicator() {
       // Calculate the Y positions for this X and adjacent X positions to draw line segment
       int xOffset = prevX - graphX;
       if (xOffset >= 0 && xOffset <= graphWidth) {
-        float inputNorm = prevSensorValue;
-        
-        // Calculate Y for current position
-        float outputNorm;
-        if (inputNorm < floorVal) {
-          outputNorm = 0.0;
-        } else if (inputNorm > ceilingVal) {
-          outputNorm = 1.0;
-        } else {
-          float mappedInput = (inputNorm - floorVal) / (ceilingVal - floorVal);
-          if (curveVal == 1) {
-            outputNorm = mappedInput;
-          } else if (curveVal == 2) {
-            outputNorm = pow(mappedInput, 2.0);
-          } else if (curveVal == 3) {
-            outputNorm = pow(mappedInput, 0.5);
-          } else {
-            outputNorm = mappedInput * mappedInput * (3.0 - 2.0 * mappedInput);
-          }
-        }
-        int y1 = graphBottom - (int)(outputNorm * graphHeight);
+        int y1 = graphBottom - (int)(response(prevSensorValue) * graphHeight);
         
         // Calculate Y for previous X position (if exists)
         if (xOffset > 0) {
-          float prevInput = (float)(xOffset - 1) / graphWidth;
-          float prevOutput;
-          if (prevInput < floorVal) {
-            prevOutput = 0.0;
-          } else if (prevInput > ceilingVal) {
-            prevOutput = 1.0;
-          } else {
-            float mappedInput = (prevInput - floorVal) / (ceilingVal - floorVal);
-            if (curveVal == 1) {
-              prevOutput = mappedInput;
-            } else if (curveVal == 2) {
-              prevOutput = pow(mappedInput, 2.0);
-            } else if (curveVal == 3) {
-              prevOutput = pow(mappedInput, 0.5);
-            } else {
-              prevOutput = mappedInput * mappedInput * (3.0 - 2.0 * mappedInput);
-            }
-          }
-          int y0 = graphBottom - (int)(prevOutput * graphHeight);
+          int y0 = graphBottom - (int)(response((float)(xOffset - 1) / graphWidth) * graphHeight);
           
           // Draw line segment from previous to current
           tft.drawLine(prevX - 1, y0, prevX, y1, COLOR_ACCENT);
@@ -1286,25 +1343,7 @@ void DisplayHandler::updateCurveSensorIndicator() {
         
         // Calculate Y for next X position (if exists)
         if (xOffset < graphWidth) {
-          float nextInput = (float)(xOffset + 1) / graphWidth;
-          float nextOutput;
-          if (nextInput < floorVal) {
-            nextOutput = 0.0;
-          } else if (nextInput > ceilingVal) {
-            nextOutput = 1.0;
-          } else {
-            float mappedInput = (nextInput - floorVal) / (ceilingVal - floorVal);
-            if (curveVal == 1) {
-              nextOutput = mappedInput;
-            } else if (curveVal == 2) {
-              nextOutput = pow(mappedInput, 2.0);
-            } else if (curveVal == 3) {
-              nextOutput = pow(mappedInput, 0.5);
-            } else {
-              nextOutput = mappedInput * mappedInput * (3.0 - 2.0 * mappedInput);
-            }
-          }
-          int y2 = graphBottom - (int)(nextOutput * graphHeight);
+          int y2 = graphBottom - (int)(response((float)(xOffset + 1) / graphWidth) * graphHeight);
           
           // Draw line segment from current to next
           tft.drawLine(prevX, y1, prevX + 1, y2, COLOR_ACCENT);
@@ -1323,6 +1362,11 @@ void DisplayHandler::updateCurveSensorIndicator() {
       }
     }
     
+    // Keep the point markers on top of the indicator
+    if (pointEditMode) {
+      drawCurvePoints();
+    }
+    
     // Clear previous value text
     if (prevSensorValue >= 0.0) {
       tft.fillRect(260, graphBottom + 2, 55, 10, COLOR_BACKGROUND);
@@ -1360,9 +1404,10 @@ void DisplayHandler::redrawEditValue() {
   if (menuDepth == 2) {
     if (mainMenuSelection == 0) items = sensorsSubMenu;
     else if (mainMenuSelection == 1) items = midiSubMenu;
-    else if (mainMenuSelection == 2) items = deviceSettingsSubMenu;
+    else if (mainMenuSelection == 2) items = matrixSubMenu;
+    else if (mainMenuSelection == 3) items = deviceSettingsSubMenu;
   } else {
-    items = sensorDetailMenu; // All sensors use same detail menu
+    items = (mainMenuSelection == 2) ? matrixSlotMenu : sensorDetailMenu; // All sensors use same detail menu
   }
   
   // Print label
@@ -1382,14 +1427,18 @@ void DisplayHandler::redrawEditValue() {
         valueStr = String((int)editValue);
       } else if (subMenuSelection == 6 || subMenuSelection == 7) {
         valueStr = editValue > 0 ? "ON" : "OFF";
+      } else if (subMenuSelection >= 8 && subMenuSelection <= 12) {
+        valueStr = resolutionNames[editValue];
       }
-    } else if (mainMenuSelection == 2) { // Device
+    } else if (mainMenuSelection == 3) { // Device
       if (subMenuSelection == 0) {
         valueStr = String((int)editValue);
       } else if (subMenuSelection == 1) {
         valueStr = String((int)editValue) + "s";
       }
     }
+  } else if (mainMenuSelection == 2) { // menuDepth == 3, matrix slot
+    valueStr = matrixValueText(thirdMenuSelection, editValue);
   } else { // menuDepth == 3
     // New sensor structure: thirdMenuSelection 0-3 = Calibration, Curve, Floor, Ceiling
     if (thirdMenuSelection == 0 || thirdMenuSelection == 2 || thirdMenuSelection == 3) {
@@ -1397,7 +1446,7 @@ void DisplayHandler::redrawEditValue() {
       valueStr = String(editValueFloat, 2);
     } else {
       // Curve is int
-      valueStr = String((int)editValue);
+      valueStr = curveText(editValue);
     }
   }
   
@@ -1418,8 +1467,10 @@ void DisplayHandler::redrawEditValue() {
         tft.print((int)editValue);
       } else if (subMenuSelection == 6 || subMenuSelection == 7) {
         tft.print(editValue > 0 ? "ON" : "OFF");
+      } else if (subMenuSelection >= 8 && subMenuSelection <= 12) {
+        tft.print(resolutionNames[editValue]);
       }
-    } else if (mainMenuSelection == 2) { // Device
+    } else if (mainMenuSelection == 3) { // Device
       if (subMenuSelection == 0) {
         tft.print((int)editValue);
       } else if (subMenuSelection == 1) {
@@ -1427,6 +1478,8 @@ void DisplayHandler::redrawEditValue() {
         tft.print("s");
       }
     }
+  } else if (mainMenuSelection == 2) { // menuDepth == 3, matrix slot
+    tft.print(valueStr);
   } else { // menuDepth == 3
     // New sensor structure: thirdMenuSelection 0-3 = Calibration, Curve, Floor, Ceiling
     if (thirdMenuSelection == 0 || thirdMenuSelection == 2 || thirdMenuSelection == 3) {
@@ -1434,7 +1487,7 @@ void DisplayHandler::redrawEditValue() {
       tft.print(editValueFloat, 2);
     } else {
       // Curve is int
-      tft.print((int)editValue);
+      tft.print(valueStr);
     }
   }
   
@@ -1449,76 +1502,106 @@ void DisplayHandler::redrawEditValue() {
 }
 
 void DisplayHandler::drawSensorValues() {
-  tft.fillScreen(COLOR_BACKGROUND);
-  tft.setTextColor(COLOR_HEADER_TEXT);
-  tft.setTextSize(2);
-  tft.setCursor(10, 10);
-  tft.println("SENSOR VALUES");
+  SensorSnapshot frame = m_sensorCache.getSnapshot();
   
-  tft.drawLine(0, 30, 320, 30, COLOR_HEADER_LINE);
+  if (needsFullRedraw) {
+    tft.fillScreen(COLOR_BACKGROUND);
+    tft.setTextColor(COLOR_HEADER_TEXT);
+    tft.setTextSize(2);
+    tft.setCursor(10, 10);
+    tft.println("SENSOR VALUES");
+    
+    tft.drawLine(0, 30, 320, 30, COLOR_HEADER_LINE);
+    
+    tft.setTextColor(COLOR_ACCENT);
+    tft.setTextSize(1);
+    tft.setCursor(10, 220);
+    tft.print("LEFT: Back");
+    needsFullRedraw = false;
+  }
   
+  // Values are redrawn in place on every refresh, one cleared line at a time
   tft.setTextColor(COLOR_MENU_TEXT);
   tft.setTextSize(1);
   
   int y = 45;
+  tft.fillRect(0, y, 320, 8, COLOR_BACKGROUND);
   tft.setCursor(10, y);
   tft.print("Breath:     ");
-  tft.print(m_sensorCache.getBreathRaw());
+  tft.print(frame.breathRaw);
   tft.print(" (");
-  tft.print(m_sensorCache.getBreathNormalized(), 2);
+  tft.print(frame.breathNormalized(), 2);
   tft.print(")");
   
   y += 20;
+  tft.fillRect(0, y, 320, 8, COLOR_BACKGROUND);
   tft.setCursor(10, y);
   tft.print("Pinch:      ");
-  tft.print(m_sensorCache.getPinchRaw());
+  tft.print(frame.pinchRaw);
   tft.print(" (");
-  tft.print(m_sensorCache.getPinchNormalized(), 2);
+  tft.print(frame.pinchNormalized(), 2);
   tft.print(")");
   
   y += 20;
+  tft.fillRect(0, y, 320, 8, COLOR_BACKGROUND);
   tft.setCursor(10, y);
   tft.print("Expression: ");
-  tft.print(m_sensorCache.getExpressionRaw());
+  tft.print(frame.expressionRaw);
   tft.print(" (");
-  tft.print(m_sensorCache.getExpressionNormalized(), 2);
+  tft.print(frame.expressionNormalized(), 2);
   tft.print(")");
   
-  if (m_sensorCache.isIMUAvailable()) {
+  if (frame.imuAvailable) {
     y += 30;
+    tft.fillRect(0, y, 320, 8, COLOR_BACKGROUND);
     tft.setCursor(10, y);
     tft.setTextColor(COLOR_VALUE_POSITIVE);
     tft.print("IMU Available");
     
     tft.setTextColor(COLOR_VALUE_NORMAL);
     y += 20;
+    tft.fillRect(0, y, 320, 8, COLOR_BACKGROUND);
     tft.setCursor(10, y);
     tft.print("Accel: ");
-    tft.print(m_sensorCache.getAccelX(), 1);
+    tft.print(frame.accelX, 1);
     tft.print(", ");
-    tft.print(m_sensorCache.getAccelY(), 1);
+    tft.print(frame.accelY, 1);
     tft.print(", ");
-    tft.print(m_sensorCache.getAccelZ(), 1);
+    tft.print(frame.accelZ, 1);
     
     y += 15;
+    tft.fillRect(0, y, 320, 8, COLOR_BACKGROUND);
     tft.setCursor(10, y);
     tft.print("Gyro:  ");
-    tft.print(m_sensorCache.getGyroX(), 1);
+    tft.print(frame.gyroX, 1);
+    tft.print(", ");
+    tft.print(frame.gyroY, 1);
+    tft.print(", ");
+    tft.print(frame.gyroZ, 1);
+    
+    y += 15;
+    tft.fillRect(0, y, 320, 8, COLOR_BACKGROUND);
+    tft.setCursor(10, y);
+    tft.print("Mag:   ");
+    tft.print(frame.magX, 1);
     tft.print(", ");
-    tft.print(m_sensorCache.getGyroY(), 1);
+    tft.print(frame.magY, 1);
     tft.print(", ");
-    tft.print(m_sensorCache.getGyroZ(), 1);
+    tft.print(frame.magZ, 1);
+    
+    y += 15;
+    tft.fillRect(0, y, 320, 8, COLOR_BACKGROUND);
+    tft.setCursor(10, y);
+    tft.print("Temp:  ");
+    tft.print(frame.temperature, 1);
+    tft.print(" C");
   } else {
     y += 30;
+    tft.fillRect(0, y, 320, 8, COLOR_BACKGROUND);
     tft.setCursor(10, y);
     tft.setTextColor(COLOR_VALUE_NEGATIVE);
     tft.print("IMU Not Available");
   }
-  
-  tft.setTextColor(COLOR_ACCENT);
-  tft.setTextSize(1);
-  tft.setCursor(10, 220);
-  tft.print("LEFT: Back");
 }
 
 void DisplayHandler::drawAbout() {
@@ -1555,6 +1638,103 @@ void DisplayHandler::drawAbout() {
   tft.print(versionText);
 }
 
+void DisplayHandler::drawLatency() {
+  static const char* portNames[] = {"USB", "DIN"};
+  
+  if (needsFullRedraw) {
+    tft.fillScreen(COLOR_BACKGROUND);
+    tft.setTextColor(COLOR_HEADER_TEXT);
+    tft.setTextSize(2);
+    tft.setCursor(10, 10);
+    tft.println("Latency");
+    
+    tft.drawLine(0, 30, 320, 30, COLOR_HEADER_LINE);
+    
+    // Column headings, all figures in microseconds
+    tft.setTextColor(COLOR_MENU_TEXT);
+    tft.setCursor(10, 45);
+    tft.print("us");
+    tft.setCursor(70, 45);
+    tft.print(" min mean  p99  max");
+    
+    tft.setTextColor(COLOR_HEADER_TEXT);
+    tft.setTextSize(1);
+    tft.setCursor(10, 220);
+    tft.print("Sensor sample to port handoff. Right: reset, Left: back");
+    needsFullRedraw = false;
+  }
+  
+  tft.setTextSize(2);
+  for (uint8_t p = 0; p < (uint8_t)MidiPort::COUNT; p++) {
+    LatencySummary latency = {0, 0, 0, 0, 0};
+    if (readLatency) latency = readLatency(p);
+    
+    int y = 80 + p * 60;
+    tft.fillRect(0, y - 2, 320, 44, COLOR_BACKGROUND);
+    tft.setTextColor(COLOR_MENU_TEXT);
+    tft.setCursor(10, y);
+    tft.print(portNames[p]);
+    
+    // Right-aligned under the four-character headings
+    uint32_t values[] = {latency.minUs, latency.meanUs, latency.p99Us, latency.maxUs};
+    tft.setTextColor(COLOR_VALUE_NORMAL);
+    for (uint8_t i = 0; i < 4; i++) {
+      String valStr = values[i] > 9999 ? String(">10k") : String(values[i]);
+      tft.setCursor(70 + i * 60 + (4 - valStr.length()) * 12, y);
+      tft.print(valStr);
+    }
+    
+    tft.setTextColor(COLOR_HEADER_TEXT);
+    tft.setTextSize(1);
+    tft.setCursor(70, y + 24);
+    tft.print(String(latency.count) + " messages");
+    tft.setTextSize(2);
+  }
+}
+
+void DisplayHandler::drawProfile() {
+  if (needsFullRedraw) {
+    tft.fillScreen(COLOR_BACKGROUND);
+    tft.setTextColor(COLOR_HEADER_TEXT);
+    tft.setTextSize(2);
+    tft.setCursor(10, 10);
+    tft.println("Profile");
+    
+    tft.drawLine(0, 30, 320, 30, COLOR_HEADER_LINE);
+    
+    // Size 1 text, 6px per char: name, then four right-aligned 9-character columns
+    tft.setTextSize(1);
+    tft.setTextColor(COLOR_MENU_TEXT);
+    tft.setCursor(10, 40);
+    tft.print("cycles              mean    worst     peak    overs");
+    
+    tft.setTextColor(COLOR_HEADER_TEXT);
+    tft.setCursor(10, 220);
+    tft.print("Worst and mean over 1 s. Right: reset, Left: back");
+    needsFullRedraw = false;
+  }
+  
+  tft.setTextSize(1);
+  for (uint8_t i = 0; i < profileSections && readProfile; i++) {
+    SectionProfile profile = readProfile(i);
+    
+    int y = 56 + i * 16;
+    tft.fillRect(0, y, 320, 8, COLOR_BACKGROUND);
+    tft.setTextColor(COLOR_MENU_TEXT);
+    tft.setCursor(10, y);
+    tft.print(profile.name);
+    
+    uint32_t values[] = {profile.meanCycles, profile.worstCycles, profile.peakCycles, profile.overruns};
+    for (uint8_t c = 0; c < 4; c++) {
+      // Overruns stand out once there are any
+      tft.setTextColor(c == 3 && profile.overruns ? COLOR_VALUE_NEGATIVE : COLOR_VALUE_NORMAL);
+      String valStr = String(values[c]);
+      tft.setCursor(10 + (24 + c * 9 - valStr.length()) * 6, y);
+      tft.print(valStr);
+    }
+  }
+}
+
 void DisplayHandler::drawEditMode() {
   if (needsFullRedraw) {
     tft.fillScreen(COLOR_BACKGROUND);
@@ -1602,7 +1782,8 @@ void DisplayHandler::drawEditMode() {
       else if (subMenuSelection == 5) tft.print("Nod CC");
       else if (subMenuSelection == 6) tft.print("USB MIDI");
       else if (subMenuSelection == 7) tft.print("Hardware MIDI");
-    } else if (mainMenuSelection == 2) { // Device Settings
+      else if (subMenuSelection >= 8 && subMenuSelection <= 12) tft.print(midiSubMenu[subMenuSelection]);
+    } else if (mainMenuSelection == 3) { // Device Settings
       if (subMenuSelection == 0) tft.print("Display Brightness");
       else if (subMenuSelection == 1) tft.print("Sleep Timeout (s)");
     }
@@ -1635,6 +1816,8 @@ void DisplayHandler::drawEditMode() {
       // Check for boolean ON/OFF settings
       if (mainMenuSelection == 1 && (subMenuSelection == 6 || subMenuSelection == 7)) {  // USB/HW MIDI
         tft.print(editValue > 0 ? "ON" : "OFF");
+      } else if (mainMenuSelection == 1 && subMenuSelection >= 8 && subMenuSelection <= 12) {  // Resolution
+        tft.print(resolutionNames[editValue]);
       } else {
         tft.print(editValue);
       }
@@ -1665,6 +1848,10 @@ void DisplayHandler::drawConfirmDialog() {
     titleX = 160 - (12 * 12) / 2; // "RESET MIDI?" = 12 chars
     tft.setCursor(titleX, 85);
     tft.println("RESET MIDI?");
+  } else if (pendingResetType == 6) {
+    titleX = 160 - (13 * 12) / 2; // "RESET MATRIX?" = 13 chars
+    tft.setCursor(titleX, 85);
+    tft.println("RESET MATRIX?");
   } else if (pendingResetType == 5) {
     titleX = 160 - (15 * 12) / 2; // "RESET SENSORS?" = 15 chars
     tft.setCursor(titleX, 85);
@@ -0,0 +1,76 @@
+#include "LatencyHistogram.h"
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    for (uint8_t i = 0; i < BINS; i++) {
+        bins[i] = 0;
+    }
+    count = 0;
+    total = 0;
+    minimum = 0xFFFFFFFF;
+    maximum = 0;
+}
+
+uint8_t LatencyHistogram::binOf(uint32_t us) {
+    if (us < LINEAR_BINS) {
+        return us;
+    }
+
+    // Octave from the top set bit, step from the two bits below it
+    uint8_t msb = 31 - __builtin_clz(us);
+    uint8_t step = (us >> (msb - 2)) & (STEPS_PER_OCTAVE - 1);
+    uint32_t bin = LINEAR_BINS + (msb - 4) * STEPS_PER_OCTAVE + step;
+    return bin < BINS ? bin : BINS - 1;
+}
+
+uint32_t LatencyHistogram::binUpper(uint8_t bin) {
+    if (bin < LINEAR_BINS) {
+        return bin;
+    }
+
+    uint8_t index = bin - LINEAR_BINS;
+    uint8_t msb = 4 + index / STEPS_PER_OCTAVE;
+    uint8_t step = index % STEPS_PER_OCTAVE;
+    uint32_t width = 1UL << (msb - 2);
+    return (STEPS_PER_OCTAVE + step) * width + width - 1;
+}
+
+void LatencyHistogram::record(uint32_t us) {
+    bins[binOf(us)]++;
+    count++;
+    total += us;
+    if (us < minimum) minimum = us;
+    if (us > maximum) maximum = us;
+}
+
+uint32_t LatencyHistogram::percentile(uint16_t perMille) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    // Smallest bin whose cumulative count reaches the rank, rounded up
+    uint32_t rank = (uint32_t)(((uint64_t)count * perMille + 999) / 1000);
+    if (rank == 0) rank = 1;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < BINS; i++) {
+        seen += bins[i];
+        if (seen >= rank) {
+            uint32_t upper = binUpper(i);
+            return upper < maximum ? upper : maximum;
+        }
+    }
+    return maximum;
+}
+
+LatencySummary LatencyHistogram::summarize() const {
+    LatencySummary summary;
+    summary.count = count;
+    summary.minUs = count ? minimum : 0;
+    summary.meanUs = count ? (uint32_t)(total / count) : 0;
+    summary.p99Us = percentile(990);
+    summary.maxUs = maximum;
+    return summary;
+}
@@ -0,0 +1,90 @@
+#include <Arduino.h>
+#include "Lpi2cPort.h"
+
+// LPI2C master register bits (i.MX RT1060 reference manual, LPI2C chapter).
+// MIER enable bits share the MSR flag positions.
+static const uint32_t MSR_TDF = 1 << 0;
+static const uint32_t MSR_RDF = 1 << 1;
+static const uint32_t MSR_EPF = 1 << 8;
+static const uint32_t MSR_SDF = 1 << 9;
+static const uint32_t MSR_NDF = 1 << 10;
+static const uint32_t MSR_ALF = 1 << 11;
+static const uint32_t MSR_FEF = 1 << 12;
+static const uint32_t MSR_PLTF = 1 << 13;
+static const uint32_t MSR_MBF = 1 << 24;
+static const uint32_t MSR_CLEARABLE = MSR_EPF | MSR_SDF | MSR_NDF | MSR_ALF | MSR_FEF | MSR_PLTF;
+
+static const uint32_t MCR_RTF = 1 << 8;
+static const uint32_t MCR_RRF = 1 << 9;
+static const uint32_t MRDR_RXEMPTY = 1 << 14;
+
+static const uint8_t LPI2C_IRQ_PRIORITY = 96;
+
+#define LPI2C IMXRT_LPI2C1
+
+void Lpi2cPort::attach(void (*isr)()) {
+    LPI2C.MIER = 0;
+    attachInterruptVector(IRQ_LPI2C1, isr);
+    NVIC_SET_PRIORITY(IRQ_LPI2C1, LPI2C_IRQ_PRIORITY);
+    NVIC_ENABLE_IRQ(IRQ_LPI2C1);
+}
+
+uint8_t Lpi2cPort::commandSpace() {
+    uint8_t size = 1 << (LPI2C.PARAM & 0x0F);
+    uint8_t used = LPI2C.MFSR & 0x07;
+    return size - used;
+}
+
+void Lpi2cPort::pushCommand(uint16_t command) {
+    LPI2C.MTDR = command;
+}
+
+bool Lpi2cPort::popData(uint8_t& data) {
+    uint32_t rdr = LPI2C.MRDR;
+    if (rdr & MRDR_RXEMPTY) {
+        return false;
+    }
+    data = rdr & 0xFF;
+    return true;
+}
+
+uint32_t Lpi2cPort::status() {
+    uint32_t msr = LPI2C.MSR;
+    uint32_t flags = 0;
+    if (msr & MSR_SDF) flags |= I2C_STATUS_STOP;
+    if (msr & MSR_NDF) flags |= I2C_STATUS_NAK;
+    if (msr & MSR_ALF) flags |= I2C_STATUS_ARB_LOST;
+    if (msr & MSR_FEF) flags |= I2C_STATUS_FIFO_ERROR;
+    if (msr & MSR_PLTF) flags |= I2C_STATUS_PIN_LOW;
+    return flags;
+}
+
+void Lpi2cPort::clearStatus(uint32_t flags) {
+    uint32_t msr = 0;
+    if (flags & I2C_STATUS_STOP) msr |= MSR_SDF;
+    if (flags & I2C_STATUS_NAK) msr |= MSR_NDF;
+    if (flags & I2C_STATUS_ARB_LOST) msr |= MSR_ALF;
+    if (flags & I2C_STATUS_FIFO_ERROR) msr |= MSR_FEF;
+    if (flags & I2C_STATUS_PIN_LOW) msr |= MSR_PLTF;
+    LPI2C.MSR = msr;
+}
+
+void Lpi2cPort::enableInterrupts(bool enabled, bool wantCommandSpace) {
+    if (!enabled) {
+        LPI2C.MIER = 0;
+        return;
+    }
+    uint32_t mier = MSR_RDF | MSR_SDF | MSR_NDF | MSR_ALF | MSR_FEF | MSR_PLTF;
+    if (wantCommandSpace) {
+        mier |= MSR_TDF;
+    }
+    LPI2C.MIER = mier;
+}
+
+void Lpi2cPort::abort() {
+    LPI2C.MCR |= MCR_RTF | MCR_RRF;
+    if (LPI2C.MSR & MSR_MBF) {
+        LPI2C.MTDR = I2C_CMD_STOP;
+    }
+    LPI2C.MSR = MSR_CLEARABLE;
+}
@@ -0,0 +1,82 @@
+#include "ModMatrix.h"
+
+ModMatrix::ModMatrix()
+    : routeCount(0)
+    , sourceMask(0)
+{
+    for (uint8_t i = 0; i < USER_CURVES; i++) {
+        userCurves[i] = SplineCurve::linear();
+    }
+}
+
+void ModMatrix::setUserCurve(uint8_t index, const CurvePoints& points) {
+    if (index < USER_CURVES) {
+        userCurves[index] = points;
+    }
+}
+
+void ModMatrix::setSlot(uint8_t index, const ModSlot& slot, float calibration) {
+    if (index >= SLOTS || !slot.isValid()) {
+        return;
+    }
+    slots[index] = slot;
+
+    // build() skips the table when the response is unchanged
+    if (slot.destination != ModDestination::NONE) {
+        const CurvePoints* points = slot.curve >= USER_CURVE_FIRST
+                                  ? &userCurves[slot.curve - USER_CURVE_FIRST] : nullptr;
+        maps[index].build(calibration, slot.curve, slot.floor / 100.0f, slot.ceiling / 100.0f, points);
+    }
+    rebuildRoutes();
+}
+
+void ModMatrix::rebuildRoutes() {
+    routeCount = 0;
+    sourceMask = 0;
+
+    for (uint8_t i = 0; i < SLOTS; i++) {
+        const ModSlot& slot = slots[i];
+        if (slot.destination == ModDestination::NONE || slot.amount == 0) {
+            continue;
+        }
+
+        Route& route = routes[routeCount++];
+        route.map = i;
+        route.source = slot.source;
+        route.destination = slot.destination;
+        route.number = slot.number;
+
+        // out = offset + value * gain: unipolar destinations invert from
+        // the top, pitch bend swings half the range either side of center
+        int32_t depth = slot.amount < 0 ? -slot.amount : slot.amount;
+        int32_t gain = depth * GAIN_ONE / 100;
+        if (slot.destination == ModDestination::PITCH_BEND) {
+            route.gain = slot.amount < 0 ? -gain / 2 : gain / 2;
+            route.offset = PITCH_BEND_CENTER;
+        } else if (slot.amount < 0) {
+            route.gain = -gain;
+            route.offset = ResponseMap::OUTPUT_MAX;
+        } else {
+            route.gain = gain;
+            route.offset = 0;
+        }
+
+        sourceMask |= 1 << (uint8_t)slot.source;
+    }
+}
+
+uint8_t ModMatrix::evaluate(const float* sources, ModOutput* outputs) const {
+    for (uint8_t i = 0; i < routeCount; i++) {
+        const Route& route = routes[i];
+        int32_t value = maps[route.map].map(sources[(uint8_t)route.source]);
+        value = route.offset + ((value * route.gain) >> 14);
+        if (value < 0) value = 0;
+        if (value > ResponseMap::OUTPUT_MAX) value = ResponseMap::OUTPUT_MAX;
+
+        outputs[i].source = route.source;
+        outputs[i].destination = route.destination;
+        outputs[i].number = route.number;
+        outputs[i].value = (uint16_t)value;
+    }
+    return routeCount;
+}
@@ -0,0 +1,71 @@
+#include "ResponseMap.h"
+#include "SignalChain.h"
+#include <string.h>
+
+ResponseMap::ResponseMap()
+    : indexScale(SIZE - 1)
+    , calibration(1.0f)
+    , curve(1)
+    , floor(0.0f)
+    , ceiling(1.0f)
+    , points(SplineCurve::linear())
+    , built(false)
+{
+    for (uint16_t i = 0; i < SIZE; i++) {
+        table[i] = 0;
+    }
+}
+
+bool ResponseMap::build(float calibration, int curve, float floor, float ceiling,
+                        const CurvePoints* points) {
+    // Only user curves depend on the points
+    bool userCurve = curve >= USER_CURVE_FIRST && curve <= CURVE_SETTING_MAX;
+    CurvePoints shape = userCurve && points ? *points : SplineCurve::linear();
+
+    if (built && calibration == this->calibration && curve == this->curve &&
+        floor == this->floor && ceiling == this->ceiling &&
+        memcmp(&shape, &this->points, sizeof(shape)) == 0) {
+        return false;
+    }
+
+    this->calibration = calibration;
+    this->curve = curve;
+    this->floor = floor;
+    this->ceiling = ceiling;
+    this->points = shape;
+    indexScale = calibration * (SIZE - 1);
+
+    SplineCurve spline;
+    spline.setPoints(shape);
+    const auto stages = SignalChain::makeChain(SignalChain::response(curve, floor, ceiling, &spline),
+                                               SignalChain::Quantize<14>());
+    for (uint16_t i = 0; i < SIZE; i++) {
+        table[i] = stages(i / (float)(SIZE - 1));
+    }
+    built = true;
+    return true;
+}
+
+uint16_t ResponseMap::map(float input) const {
+    float position = input * indexScale;
+    if (!(position > 0.0f)) {
+        return table[0];
+    }
+    if (position >= SIZE - 1) {
+        return table[SIZE - 1];
+    }
+
+    // Interpolate so 16-bit breath and float gyro keep their resolution
+    uint16_t index = (uint16_t)position;
+    float fraction = position - index;
+    int32_t low = table[index];
+    int32_t high = table[index + 1];
+    return (uint16_t)(low + (int32_t)((high - low) * fraction + 0.5f));
+}
+
+float ResponseMap::evaluate(float input, int curve, float floor, float ceiling,
+                           const CurvePoints* points) {
+    SplineCurve spline;
+    if (points) spline.setPoints(*points);
+    return SignalChain::response(curve, floor, ceiling, &spline)(input);
+}
@@ -0,0 +1,60 @@
+#include "ResponseMapper.h"
+
+ResponseMapper::ResponseMapper(const UserSettings& settings)
+    : settings(settings)
+    , active(0)
+    , revision(0)
+    , primed(false)
+{
+}
+
+// Percent with the rounding the 0.01 menu steps need
+static uint8_t toPercent(float value) {
+    return (uint8_t)(value * 100.0f + 0.5f);
+}
+
+void ResponseMapper::update() {
+    if (primed && settings.getRevision() == revision) {
+        return;
+    }
+    revision = settings.getRevision();
+    primed = true;
+
+    // The standby matrix still holds the tables from two updates ago;
+    // build() only redoes the ones that differ
+    ModMatrix& matrix = matrices[active ^ 1];
+
+    static const ModDestination byResolution[] = {
+        ModDestination::CC,       // STANDARD
+        ModDestination::CC_14BIT, // HIGH_RES
+        ModDestination::NRPN      // NRPN
+    };
+
+    // Points first: the slots compile them into their tables
+    for (uint8_t i = 0; i < USER_CURVES; i++) {
+        matrix.setUserCurve(i, settings.getUserCurve(i));
+    }
+
+    for (uint8_t i = 0; i < UserSettings::CHANNELS; i++) {
+        SensorChannel channel = (SensorChannel)i;
+        ModSlot slot;
+        slot.source = (ModSource)i;
+        slot.destination = byResolution[(uint8_t)settings.getResolution(channel)];
+        slot.number = settings.getCC(channel) & 0x7F;
+        slot.curve = settings.getCurve(channel);
+        slot.floor = toPercent(settings.getFloor(channel));
+        slot.ceiling = toPercent(settings.getCeiling(channel));
+        matrix.setSlot(i, slot, settings.getCal(channel));
+    }
+
+    // User routes share a sensor's calibration; the IMU-derived sources
+    // arrive already normalized to 0-1
+    for (uint8_t i = 0; i < UserSettings::MOD_SLOTS; i++) {
+        const ModSlot& slot = settings.getModSlot(i);
+        float calibration = slot.source < ModSource::TWIST ?
+                            settings.getCal((SensorChannel)slot.source) : 1.0f;
+        matrix.setSlot(USER_SLOT_BASE + i, slot, calibration);
+    }
+
+    active ^= 1;
+}
@@ -1,15 +1,54 @@
 #include "SensorCache.h"
 
+SensorCache* SensorCache::instance = nullptr;
+
 SensorCache::SensorCache() 
     : breathRaw(0)
+    , breathHiRes(0)
+    , breathLevel(0)
+    , breathBaseline(0)
+    , analogCycles(0)
+    , imuCycles(0)
     , expressionRaw(0)
     , pinchRaw(0)
+    , sampler(BREATH_PIN, PINCH_PIN, EXPRESSION_PIN)
+    , breathPrimed(false)
     , accelX(0), accelY(0), accelZ(0)
     , gyroX(0), gyroY(0), gyroZ(0)
     , magX(0), magY(0), magZ(0)
     , temperature(0)
     , imu(ICM20948_ADDR)
     , imuAvailable(false)
+    , imuMode(ImuMode::POLLED)
+    , accelOffset{0, 0, 0}
+    , gyroOffset{0, 0, 0}
+    , imuFifoOverflows(0)
+    , imuFifoRunning(false)
+    , lastImuAuxRead(0)
+    , imuBus(imuPort)
+    , imuAsyncFailures(0)
+    , imuAsyncBackoff(false)
+    , imuBackoffStart(0)
+    , imuBusResetPending(false)
+    , imuBusResets(0)
+    , imuSkippedReads(0)
+    , imuReadStart(0)
+    , imuReadCycles(0)
+    , imuReadFields(0)
+    , imuDemand{}
+    , imuFields(0)
+    , imuWindowStart(0)
+    , imuWindowLength(0)
+    , imuDataReadyMode(false)
+    , imuDataPending(false)
+    , imuReadyTime(0)
+    , adaptive{ANALOG_SAMPLE_RATE, ANALOG_SAMPLE_RATE, 0, 0, 0, 0}
+    , adaptiveEnabled(false)
+    , samplingActive(true)
+    , lastActivityTime(0)
+    , snapshotSequence(0)
+    , orientationPrimed(false)
+    , lastOrientationTime(0)
     , lastUpdate(0)
     , updateInterval(10)
 {
@@ -19,8 +58,10 @@ bool SensorCache::begin() {
     pinMode(BREATH_PIN, INPUT_PULLUP);
     pinMode(EXPRESSION_PIN, INPUT_PULLUP);
     pinMode(PINCH_PIN, INPUT_PULLUP);
-    analogReadResolution(12);
     
+    if (!sampler.begin(ANALOG_SAMPLE_RATE)) {
+        Serial.println("Analog sampler failed to start!");
+    }
 
     Wire.begin();
     Wire.setClock(400000);
@@ -32,23 +73,27 @@ bool SensorCache::begin() {
         Serial.println("ICM-20948 initialized successfully");
         imuAvailable = true;
         
+        // autoOffsets() leaves the chip at 2G/250dps, so run it before the
+        // ranges below are applied; the offsets are rescaled by the library
+        imu.autoOffsets();
+        
         imu.setAccRange(ICM20948_ACC_RANGE_16G);
         
 
         imu.setAccDLPF(ICM20948_DLPF_6);
-        imu.setAccSampleRateDivider(10);
+        imu.setAccSampleRateDivider(IMU_SAMPLE_RATE_DIV);
         
         imu.setGyrRange(ICM20948_GYRO_RANGE_2000);
 
         imu.setGyrDLPF(ICM20948_DLPF_6);
-        imu.setGyrSampleRateDivider(10);
+        imu.setGyrSampleRateDivider(IMU_SAMPLE_RATE_DIV);
         
         imu.setMagOpMode(AK09916_CONT_MODE_100HZ);
         
         imu.enableAcc(true);
         imu.enableGyr(true);
         
-        imu.autoOffsets();
+        captureImuOffsets();
     }
     
     update();
@@ -59,17 +104,321 @@ bool SensorCache::begin() {
 void SensorCache::update() {
     unsigned long currentTime = millis();
     
-    if (currentTime - lastUpdate >= updateInterval) {
-        updateAnalogSensors();
-        updateIMU();
-        lastUpdate = currentTime;
+    // Analog samples are paced by the sampler timer, so drain them every call
+    updateAnalogSensors();
+    
+    // Publish a finished asynchronous IMU read as soon as it lands
+    if (imuMode == ImuMode::ASYNC) {
+        collectImuAsync();
+    }
+    
+    if (imuDataReadyMode && samplingActive) {
+        noInterrupts();
+        bool pending = imuDataPending;
+        imuDataPending = false;
+        // Keep reading on a slow timer if the INT line goes quiet
+        bool stalled = micros() - imuReadyTime > IMU_DATA_READY_TIMEOUT_US;
+        if (stalled) {
+            imuReadyTime = micros();
+        }
+        interrupts();
+        
+        if (pending || stalled) {
+            updateIMU();
+            lastUpdate = currentTime;
+        }
+    } else {
+        unsigned long interval = samplingActive ? updateInterval : adaptive.idleImuInterval;
+        if (currentTime - lastUpdate >= interval) {
+            updateIMU();
+            lastUpdate = currentTime;
+        }
+    }
+    
+    updateActivity(currentTime);
+    publishSnapshot();
+}
+
+void SensorCache::setAdaptiveSampling(const AdaptiveSamplingConfig& config) {
+    adaptive = config;
+    adaptive.activeRateHz = constrain(config.activeRateHz, AnalogSampler::MIN_SAMPLE_RATE, AnalogSampler::MAX_SAMPLE_RATE);
+    adaptive.idleRateHz = constrain(config.idleRateHz, AnalogSampler::MIN_SAMPLE_RATE, adaptive.activeRateHz);
+    adaptiveEnabled = true;
+    
+    // Start active so the first note isn't played at the idle rate
+    lastActivityTime = millis();
+    setSamplingActive(true);
+}
+
+void SensorCache::disableAdaptiveSampling() {
+    adaptiveEnabled = false;
+    samplingActive = true;
+    sampler.setSampleRate(ANALOG_SAMPLE_RATE);
+}
+
+void SensorCache::updateActivity(unsigned long now) {
+    if (!adaptiveEnabled) {
+        return;
+    }
+    
+    bool breathActive = getBreathNormalized() > adaptive.breathThreshold;
+    
+    float motion = max(fabsf(gyroX), max(fabsf(gyroY), fabsf(gyroZ)));
+    bool moving = imuAvailable && motion > adaptive.motionThreshold;
+    
+    if (breathActive || moving) {
+        lastActivityTime = now;
+        if (!samplingActive) {
+            setSamplingActive(true);
+        }
+    } else if (samplingActive && now - lastActivityTime >= adaptive.idleTimeout) {
+        setSamplingActive(false);
     }
 }
 
+void SensorCache::setSamplingActive(bool active) {
+    samplingActive = active;
+    sampler.setSampleRate(active ? adaptive.activeRateHz : adaptive.idleRateHz);
+    
+    if (active) {
+        // Drop an edge latched while idle; the next one starts a fresh read
+        noInterrupts();
+        imuDataPending = false;
+        imuReadyTime = micros();
+        interrupts();
+    }
+}
+
+void SensorCache::publishSnapshot() {
+    SensorSnapshot frame;
+    frame.timestamp = micros();
+    frame.sequence = ++snapshotSequence;
+    frame.analogCycles = analogCycles;
+    frame.imuCycles = imuCycles;
+    
+    frame.breathRaw = breathRaw;
+    frame.breathHiRes = breathHiRes;
+    frame.breathLevel = breathLevel;
+    frame.expressionRaw = expressionRaw;
+    frame.pinchRaw = pinchRaw;
+    
+    frame.accelX = accelX;
+    frame.accelY = accelY;
+    frame.accelZ = accelZ;
+    frame.gyroX = gyroX;
+    frame.gyroY = gyroY;
+    frame.gyroZ = gyroZ;
+    frame.magX = magX;
+    frame.magY = magY;
+    frame.magZ = magZ;
+    frame.temperature = temperature;
+    frame.roll = orientation.getRoll();
+    frame.pitch = orientation.getPitch();
+    frame.yaw = orientation.getYaw();
+    frame.imuAvailable = imuAvailable;
+    
+    snapshot.write(frame);
+}
+
 void SensorCache::updateAnalogSensors() {
-    breathRaw = analogRead(BREATH_PIN);
-    expressionRaw = analogRead(EXPRESSION_PIN);
-    pinchRaw = analogRead(PINCH_PIN);
+    AnalogBlock block;
+    while (sampler.readBlock(block)) {
+        consumeAnalogBlock(block);
+    }
+}
+
+void SensorCache::consumeAnalogBlock(const AnalogBlock& block) {
+    static_assert(AnalogBlock::LENGTH == CicDecimator::RATIO,
+                  "breath decimator consumes exactly one block per output");
+    
+    // Breath goes through the CIC/FIR decimator for a 16-bit result
+    if (!breathPrimed) {
+        breathDecimator.reset(block.breath[0]);
+        breathBaseline = block.breath[0] * (float)CicDecimator::RATIO;
+        breathPrimed = true;
+    }
+    breathHiRes = breathDecimator.process(block.breath);
+    breathRaw = breathHiRes >> 4;
+    trackBreathBaseline();
+    
+    pinchRaw = AnalogBlock::average(block.pinch);
+    expressionRaw = AnalogBlock::average(block.expression);
+    analogCycles = block.cycles;
+}
+
+void SensorCache::trackBreathBaseline() {
+    float input = breathHiRes;
+    float offset = input - breathBaseline;
+    
+    // One decimated output per block, so the step depends on the sample rate
+    float dt = CicDecimator::RATIO / (float)sampler.getSampleRate();
+    if (offset < 0) {
+        // Resting pressure can't be below the baseline, so catch up quickly
+        breathBaseline += offset * min(1.0f, dt / BASELINE_FALL_TAU);
+    } else if (offset < BASELINE_GATE) {
+        // No breath: learn the drift slowly. Anything above the gate is
+        // playing and leaves the baseline alone.
+        breathBaseline += offset * (dt / BASELINE_RISE_TAU);
+    }
+    
+    // Stretch what's left above the baseline back to full scale
+    offset = input - breathBaseline;
+    float range = CicDecimator::FULL_SCALE - breathBaseline;
+    float level = 0;
+    if (offset > 0 && range > 0) {
+        level = offset * CicDecimator::FULL_SCALE / range;
+    }
+    breathLevel = (uint16_t)min(level, (float)CicDecimator::FULL_SCALE);
+}
+
+bool SensorCache::setImuMode(ImuMode mode) {
+    if (!imuAvailable) {
+        return false;
+    }
+    if (mode == imuMode) {
+        return true;
+    }
+    
+    // Blocking library calls below must not overlap an interrupt transfer
+    if (imuDataReadyMode) {
+        detachInterrupt(digitalPinToInterrupt(IMU_INT_PIN));
+    }
+    waitImuIdle();
+    
+    if (mode == ImuMode::FIFO) {
+        imu.enableFifo(true);
+        imu.setFifoMode(ICM20948_CONTINUOUS);
+        imu.resetFifo();
+        imu.startFifo(ICM20948_FIFO_ACC_GYR);
+        imuFifoRunning = true;
+    } else if (imuMode == ImuMode::FIFO) {
+        imu.stopFifo();
+        imu.enableFifo(false);
+        imuFifoRunning = false;
+    }
+    
+    if (mode == ImuMode::ASYNC) {
+        imuBus.begin();
+        imuAsyncFailures = 0;
+        imuAsyncBackoff = imuBusResetPending; // a pending reset still runs first
+    }
+    
+    imuMode = mode;
+    
+    if (imuDataReadyMode) {
+        attachInterrupt(digitalPinToInterrupt(IMU_INT_PIN), dataReadyISR, RISING);
+    }
+    return true;
+}
+
+bool SensorCache::setImuDataReadyMode(bool enabled) {
+    if (!imuAvailable) {
+        return false;
+    }
+    if (enabled == imuDataReadyMode) {
+        return true;
+    }
+    
+    if (enabled) {
+        waitImuIdle();
+        instance = this;
+        
+        // Unlatched: a 50 us pulse per sample, so a missed read can't leave
+        // the line high and stop further edges
+        imu.setIntPinPolarity(ICM20948_ACT_HIGH);
+        imu.enableIntLatch(false);
+        imu.enableInterrupt(ICM20948_DATA_READY_INT);
+        
+        imuDataPending = false;
+        imuReadyTime = micros();
+        imuDataReadyMode = true;
+        pinMode(IMU_INT_PIN, INPUT);
+        attachInterrupt(digitalPinToInterrupt(IMU_INT_PIN), dataReadyISR, RISING);
+    } else {
+        detachInterrupt(digitalPinToInterrupt(IMU_INT_PIN));
+        imuDataReadyMode = false;
+        waitImuIdle();
+        imu.disableInterrupt(ICM20948_DATA_READY_INT);
+    }
+    return true;
+}
+
+void SensorCache::dataReadyISR() {
+    instance->onImuDataReady();
+}
+
+void SensorCache::onImuDataReady() {
+    uint32_t cycles = ARM_DWT_CYCCNT;
+    imuReadyTime = micros();
+    
+    // When idle, reads are paced by update() instead
+    if (!samplingActive) {
+        return;
+    }
+    
+    // In async mode the read starts right here, aligned with the sample
+    if (imuMode == ImuMode::ASYNC && !imuAsyncBackoff && imuBus.isIdle()) {
+        beginImuRead(imuReadyTime, cycles);
+    } else {
+        imuDataPending = true;
+    }
+}
+
+void SensorCache::requestImuFields(ImuConsumer consumer, uint8_t fields) {
+    imuDemand[(uint8_t)consumer] = fields & IMU_ALL;
+    
+    uint8_t combined = 0;
+    for (uint8_t i = 0; i < (uint8_t)ImuConsumer::COUNT; i++) {
+        combined |= imuDemand[i];
+    }
+    if (combined == imuFields) {
+        return;
+    }
+    
+    uint8_t start;
+    uint8_t length;
+    imuWindow(combined, start, length);
+    
+    // The data-ready ISR reads these to start transfers
+    noInterrupts();
+    imuFields = combined;
+    imuWindowStart = start;
+    imuWindowLength = length;
+    interrupts();
+}
+
+void SensorCache::imuWindow(uint8_t fields, uint8_t& start, uint8_t& length) {
+    // Groups are contiguous from ACCEL_XOUT_H, so read from the first
+    // requested group to the end of the last one
+    static const uint8_t groupStart[] = {IMU_ACCEL_OFFSET, IMU_GYRO_OFFSET, IMU_TEMP_OFFSET, IMU_MAG_OFFSET};
+    static const uint8_t groupEnd[] = {IMU_GYRO_OFFSET, IMU_TEMP_OFFSET, IMU_MAG_OFFSET, IMU_DATA_BYTES};
+    
+    start = IMU_DATA_BYTES;
+    uint8_t end = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        if (fields & (1 << i)) {
+            start = min(start, groupStart[i]);
+            end = max(end, groupEnd[i]);
+        }
+    }
+    
+    if (end == 0) {
+        start = 0;
+        length = 0;
+    } else {
+        length = end - start;
+    }
+}
+
+void SensorCache::waitImuIdle() {
+    if (imuMode != ImuMode::ASYNC) {
+        return;
+    }
+    while (imuBus.poll(micros()) == I2CState::BUSY) {
+    }
+    if (!imuBus.isIdle()) {
+        collectImuAsync();
+    }
 }
 
 void SensorCache::updateIMU() {
@@ -77,25 +426,332 @@ void SensorCache::updateIMU() {
         return;
     }
     
+    if (imuFields == 0) {
+        // Nobody reads the FIFO now, so stop it rather than let it overflow
+        if (imuMode == ImuMode::FIFO && imuFifoRunning) {
+            imu.stopFifo();
+            imuFifoRunning = false;
+        }
+        return;
+    }
+    
+    if (imuMode == ImuMode::FIFO) {
+        if (!imuFifoRunning) {
+            // Restart empty, so the first drain after an idle spell is not
+            // taken for an overflow
+            imu.resetFifo();
+            imu.startFifo(ICM20948_FIFO_ACC_GYR);
+            imuFifoRunning = true;
+        }
+        drainImuFifo();
+    } else if (imuMode == ImuMode::ASYNC) {
+        startImuAsync();
+    } else {
+        readImuPolled();
+    }
+}
+
+void SensorCache::startImuAsync() {
+    // This runs in the control interrupt, so a failing bus is never read
+    // with blocking Wire calls; the IMU values hold until it recovers
+    if (imuAsyncBackoff) {
+        if (imuBusResetPending || millis() - imuBackoffStart < IMU_ASYNC_RETRY_INTERVAL) {
+            imuSkippedReads++;
+            return;
+        }
+        imuAsyncBackoff = false;
+        imuAsyncFailures = 0;
+    }
+    
+    // A read still in flight is simply left to finish. The data-ready ISR
+    // can also start reads, so check and start with interrupts off.
+    noInterrupts();
+    if (imuBus.isIdle()) {
+        beginImuRead(micros(), ARM_DWT_CYCCNT);
+    }
+    interrupts();
+}
+
+bool SensorCache::beginImuRead(uint32_t now, uint32_t cycles) {
+    if (imuWindowLength == 0) {
+        return false;
+    }
+    
+    // Data lands at its offset in imuBuffer so decoding is layout-fixed
+    imuReadStart = now;
+    imuReadCycles = cycles;
+    imuReadFields = imuFields;
+    return imuBus.startRead(ICM20948_ADDR, REG_ACCEL_XOUT_H + imuWindowStart,
+                            imuBuffer + imuWindowStart, imuWindowLength,
+                            now, IMU_ASYNC_TIMEOUT_US);
+}
+
+void SensorCache::collectImuAsync() {
+    I2CState state = imuBus.poll(micros());
+    
+    if (state == I2CState::DONE) {
+        decodeImuData(imuBuffer, imuReadFields, imuReadStart, imuReadCycles);
+        imuAsyncFailures = 0;
+    } else if (state == I2CState::FAILED) {
+        if (++imuAsyncFailures >= IMU_ASYNC_MAX_FAILURES) {
+            // Leave the bus alone until loop() has reset it, then for a
+            // while longer before trying again
+            imuAsyncBackoff = true;
+            imuBackoffStart = millis();
+            imuBusResetPending = true;
+        }
+    }
+    
+    // Only a result seen here; one that lands after poll() waits for the
+    // next call rather than being dropped
+    if (state == I2CState::DONE || state == I2CState::FAILED) {
+        imuBus.acknowledge();
+    }
+}
+
+void SensorCache::decodeAccelGyro(const uint8_t* data, ImuSample& sample) const {
+    // 16G range: 2048 LSB/g, 2000 dps range: 16.4 LSB/dps
+    const float accelScale = 1.0f / 2048.0f;
+    const float gyroScale = 2000.0f / 32768.0f;
+    
+    sample.accelX = ((int16_t)((data[0] << 8) | data[1]) - accelOffset.x) * accelScale;
+    sample.accelY = ((int16_t)((data[2] << 8) | data[3]) - accelOffset.y) * accelScale;
+    sample.accelZ = ((int16_t)((data[4] << 8) | data[5]) - accelOffset.z) * accelScale;
+    sample.gyroX = ((int16_t)((data[6] << 8) | data[7]) - gyroOffset.x) * gyroScale;
+    sample.gyroY = ((int16_t)((data[8] << 8) | data[9]) - gyroOffset.y) * gyroScale;
+    sample.gyroZ = ((int16_t)((data[10] << 8) | data[11]) - gyroOffset.z) * gyroScale;
+}
+
+void SensorCache::decodeImuData(const uint8_t* data, uint8_t fields, uint32_t timestamp, uint32_t cycles) {
+    // Mag first so the fusion step sees the matching reading.
+    // Same conversions as ICM20948_WE::getTemperature()/getMagValues()
+    if (fields & IMU_TEMP) {
+        const uint8_t* t = &data[IMU_TEMP_OFFSET];
+        int16_t rawTemp = (int16_t)((t[0] << 8) | t[1]);
+        temperature = rawTemp / 333.87f + 21.0f;
+    }
+    
+    if (fields & IMU_MAG) {
+        // AK09916 data is little-endian
+        const uint8_t* m = &data[IMU_MAG_OFFSET];
+        const float magScale = 0.1495f; // uT per LSB
+        magX = (int16_t)((m[1] << 8) | m[0]) * magScale;
+        magY = (int16_t)((m[3] << 8) | m[2]) * magScale;
+        magZ = (int16_t)((m[5] << 8) | m[4]) * magScale;
+    }
+    
+    if (!(fields & (IMU_ACCEL | IMU_GYRO))) {
+        return;
+    }
+    
+    ImuSample sample;
+    decodeAccelGyro(data, sample);
+    sample.timestamp = timestamp;
+    sample.cycles = cycles;
+    sample.fields = fields & (IMU_ACCEL | IMU_GYRO);
+    
+    // Groups that weren't read keep their last values
+    if (!(fields & IMU_ACCEL)) {
+        sample.accelX = accelX;
+        sample.accelY = accelY;
+        sample.accelZ = accelZ;
+    }
+    if (!(fields & IMU_GYRO)) {
+        sample.gyroX = gyroX;
+        sample.gyroY = gyroY;
+        sample.gyroZ = gyroZ;
+    }
+    publishImuSample(sample);
+}
+
+void SensorCache::serviceImuBus() {
+    if (!imuBusResetPending) {
+        return;
+    }
+    // No transfer is running: the interrupt stops starting them when it
+    // sets the flag, and the failed one has been acknowledged
+    recoverImuBus();
+    
+    // Wire.begin() resets LPI2C1 underneath AsyncI2C, so attach it again
+    Wire.begin();
+    Wire.setClock(400000);
+    imuBus.begin();
+    
+    imuBusResets++;
+    imuBackoffStart = millis();
+    imuBusResetPending = false;
+}
+
+// Standard I2C bus recovery: a slave cut off mid-byte holds SDA low until
+// it has clocked out its byte, so toggle SCL by hand (up to nine clocks)
+// until SDA is released, then send a STOP
+void SensorCache::recoverImuBus() {
+    pinMode(IMU_SDA_PIN, INPUT_PULLUP);
+    pinMode(IMU_SCL_PIN, OUTPUT_OPENDRAIN);
+    digitalWrite(IMU_SCL_PIN, HIGH);
+    delayMicroseconds(5);
+    
+    for (uint8_t i = 0; i < 9 && digitalRead(IMU_SDA_PIN) == LOW; i++) {
+        digitalWrite(IMU_SCL_PIN, LOW);
+        delayMicroseconds(5);
+        digitalWrite(IMU_SCL_PIN, HIGH);
+        delayMicroseconds(5);
+    }
+    
+    // STOP: SDA rises while SCL is high
+    pinMode(IMU_SDA_PIN, OUTPUT_OPENDRAIN);
+    digitalWrite(IMU_SCL_PIN, LOW);
+    digitalWrite(IMU_SDA_PIN, LOW);
+    delayMicroseconds(5);
+    digitalWrite(IMU_SCL_PIN, HIGH);
+    delayMicroseconds(5);
+    digitalWrite(IMU_SDA_PIN, HIGH);
+    delayMicroseconds(5);
+}
+
+void SensorCache::readImuPolled() {
+    uint8_t fields = imuFields;
+    uint8_t start = imuWindowStart;
+    uint8_t length = imuWindowLength;
+    
+    // The IMU samples on its own clock; the start of the read is the
+    // nearest instant known here
+    uint32_t now = micros();
+    uint32_t cycles = ARM_DWT_CYCCNT;
+    if (readImuRegisters(REG_ACCEL_XOUT_H + start, imuBuffer + start, length)) {
+        decodeImuData(imuBuffer, fields, now, cycles);
+    }
+}
+
+void SensorCache::drainImuFifo() {
+    uint8_t countBytes[2];
+    if (!readImuRegisters(REG_FIFO_COUNTH, countBytes, 2)) {
+        return;
+    }
+    uint16_t count = ((countBytes[0] & 0x1F) << 8) | countBytes[1];
+    
+    // A full FIFO has wrapped and may no longer start on a frame boundary
+    if (count >= IMU_FIFO_SIZE - IMU_FIFO_FRAME_BYTES || count % IMU_FIFO_FRAME_BYTES != 0) {
+        imu.resetFifo();
+        imuFifoOverflows++;
+        return;
+    }
+    
+    uint16_t frames = count / IMU_FIFO_FRAME_BYTES;
+    uint32_t now = micros();
+    uint32_t nowCycles = ARM_DWT_CYCCNT;
+    const uint32_t cyclesPerSample = IMU_SAMPLE_PERIOD_US * (F_CPU_ACTUAL / 1000000);
+    
+    uint8_t buffer[IMU_FIFO_BURST_FRAMES * IMU_FIFO_FRAME_BYTES];
+    uint16_t frame = 0;
+    while (frame < frames) {
+        uint8_t burst = min((uint16_t)IMU_FIFO_BURST_FRAMES, (uint16_t)(frames - frame));
+        if (!readImuRegisters(REG_FIFO_R_W, buffer, burst * IMU_FIFO_FRAME_BYTES)) {
+            imu.resetFifo();
+            return;
+        }
+        
+        for (uint8_t i = 0; i < burst; i++, frame++) {
+            ImuSample sample;
+            decodeAccelGyro(&buffer[i * IMU_FIFO_FRAME_BYTES], sample);
+            sample.fields = IMU_ACCEL | IMU_GYRO;
+            // Newest frame was sampled at most one period ago; step back from it
+            sample.timestamp = now - (frames - 1 - frame) * IMU_SAMPLE_PERIOD_US;
+            sample.cycles = nowCycles - (frames - 1 - frame) * cyclesPerSample;
+            publishImuSample(sample);
+        }
+    }
+    
+    // Mag and temperature are not in the FIFO and change slowly
+    unsigned long currentTime = millis();
+    if ((imuFields & (IMU_TEMP | IMU_MAG)) && currentTime - lastImuAuxRead >= IMU_AUX_INTERVAL) {
+        lastImuAuxRead = currentTime;
+        readImuAux();
+    }
+}
+
+void SensorCache::readImuAux() {
+    uint8_t fields = imuFields & (IMU_TEMP | IMU_MAG);
+    uint8_t start;
+    uint8_t length;
+    imuWindow(fields, start, length);
+    
+    if (readImuRegisters(REG_ACCEL_XOUT_H + start, imuBuffer + start, length)) {
+        decodeImuData(imuBuffer, fields, micros(), ARM_DWT_CYCCNT);
+    }
+}
+
+void SensorCache::publishImuSample(const ImuSample& sample) {
+    accelX = sample.accelX;
+    accelY = sample.accelY;
+    accelZ = sample.accelZ;
+    gyroX = sample.gyroX;
+    gyroY = sample.gyroY;
+    gyroZ = sample.gyroZ;
+    imuCycles = sample.cycles;
+    
+    // Fusion needs both accel and gyro from the same instant
+    if (sample.fields == (IMU_ACCEL | IMU_GYRO)) {
+        updateOrientation(sample);
+    }
+}
+
+void SensorCache::updateOrientation(const ImuSample& sample) {
+    if (!orientationPrimed) {
+        orientation.reset(sample.accelX, sample.accelY, sample.accelZ);
+        lastOrientationTime = sample.timestamp;
+        orientationPrimed = true;
+        return;
+    }
+    
+    float dt = (sample.timestamp - lastOrientationTime) * 1e-6f;
+    lastOrientationTime = sample.timestamp;
+    if (dt <= 0.0f) {
+        return; // duplicate
+    }
+    // Idle sampling leaves long gaps; the gyro rate isn't known across
+    // them, so integrate one bounded step and let accel/mag correct the rest
+    dt = min(dt, ORIENTATION_MAX_DT);
+    
+    // AK09916 axes are X = X, Y = -Y, Z = -Z relative to the accel/gyro frame
+    orientation.update(sample.gyroX, sample.gyroY, sample.gyroZ,
+                       sample.accelX, sample.accelY, sample.accelZ,
+                       magX, -magY, -magZ, dt);
+}
+
+void SensorCache::captureImuOffsets() {
+    // The library applies its offsets internally; recover them so frames
+    // read straight from the FIFO get the same correction
     imu.readSensor();
     
-    xyzFloat accel;
-    imu.getGValues(&accel);
-    accelX = accel.x;
-    accelY = accel.y;
-    accelZ = accel.z;
-    
-    xyzFloat gyro;
-    imu.getGyrValues(&gyro);
-    gyroX = gyro.x;
-    gyroY = gyro.y;
-    gyroZ = gyro.z;
-    
-    xyzFloat mag;
-    imu.getMagValues(&mag);
-    magX = mag.x;
-    magY = mag.y;
-    magZ = mag.z;
-    
-    temperature = imu.getTemperature();
+    xyzFloat raw;
+    xyzFloat corrected;
+    imu.getAccRawValues(&raw);
+    imu.getCorrectedAccRawValues(&corrected);
+    accelOffset.x = raw.x - corrected.x;
+    accelOffset.y = raw.y - corrected.y;
+    accelOffset.z = raw.z - corrected.z;
+    
+    imu.getGyrRawValues(&raw);
+    imu.getCorrectedGyrRawValues(&corrected);
+    gyroOffset.x = raw.x - corrected.x;
+    gyroOffset.y = raw.y - corrected.y;
+    gyroOffset.z = raw.z - corrected.z;
+}
+
+bool SensorCache::readImuRegisters(uint8_t reg, uint8_t* buffer, uint8_t length) {
+    // Direct reads rely on the library leaving the chip in register bank 0,
+    // which it does after begin() and every FIFO call
+    Wire.beginTransmission(ICM20948_ADDR);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) != 0) {
+        return false;
+    }
+    if (Wire.requestFrom(ICM20948_ADDR, length) != length) {
+        return false;
+    }
+    for (uint8_t i = 0; i < length; i++) {
+        buffer[i] = Wire.read();
+    }
+    return true;
 }
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "SplineCurve.h"
+
+SplineCurve::SplineCurve() {
+    setPoints(linear());
+}
+
+CurvePoints SplineCurve::linear() {
+    CurvePoints points;
+    for (uint8_t i = 0; i < CURVE_POINTS; i++) {
+        points.level[i] = (uint8_t)((i * 255 + (CURVE_POINTS - 1) / 2) / (CURVE_POINTS - 1));
+    }
+    return points;
+}
+
+void SplineCurve::setPoints(const CurvePoints& points) {
+    float delta[CURVE_POINTS - 1];
+    for (uint8_t i = 0; i < CURVE_POINTS; i++) {
+        level[i] = points.level[i] / 255.0f;
+    }
+    for (uint8_t i = 0; i < CURVE_POINTS - 1; i++) {
+        delta[i] = level[i + 1] - level[i];
+    }
+
+    // Harmonic mean of the neighbouring secants, zero at a local extremum.
+    // It never exceeds twice the smaller secant, which keeps each segment
+    // monotonic without a separate limiting pass.
+    slope[0] = delta[0];
+    slope[CURVE_POINTS - 1] = delta[CURVE_POINTS - 2];
+    for (uint8_t i = 1; i < CURVE_POINTS - 1; i++) {
+        float before = delta[i - 1];
+        float after = delta[i];
+        if (before * after <= 0.0f) {
+            slope[i] = 0.0f;
+        } else {
+            slope[i] = 2.0f * before * after / (before + after);
+        }
+    }
+}
+
+float SplineCurve::operator()(float x) const {
+    if (!(x > 0.0f)) return level[0];
+    if (x >= 1.0f) return level[CURVE_POINTS - 1];
+
+    float position = x * (CURVE_POINTS - 1);
+    uint8_t i = (uint8_t)position;
+    float t = position - i;
+
+    // Cubic Hermite basis on the unit segment
+    float t2 = t * t;
+    float t3 = t2 * t;
+    float y = (2.0f * t3 - 3.0f * t2 + 1.0f) * level[i]
+            + (t3 - 2.0f * t2 + t) * slope[i]
+            + (-2.0f * t3 + 3.0f * t2) * level[i + 1]
+            + (t3 - t2) * slope[i + 1];
+
+    if (y < 0.0f) y = 0.0f;
+    if (y > 1.0f) y = 1.0f;
+    return y;
+}
@@ -0,0 +1,88 @@
+#include "TaskScheduler.h"
+
+TaskScheduler::TaskScheduler(ClockFunction clock)
+    : clock(clock)
+    , taskCount(0)
+{
+}
+
+uint8_t TaskScheduler::addTask(TaskFunction function, uint32_t periodUs, uint32_t deadlineUs) {
+    if (taskCount >= MAX_TASKS || periodUs == 0 || !function) {
+        return NO_TASK;
+    }
+
+    Task& task = tasks[taskCount];
+    task.function = function;
+    task.period = periodUs;
+    task.deadline = deadlineUs ? deadlineUs : periodUs;
+    task.release = clock();
+    task.stats = TaskStats();
+    return taskCount++;
+}
+
+bool TaskScheduler::runOnce() {
+    uint32_t now = clock();
+
+    // Earliest deadline first among the released tasks; signed differences
+    // keep the comparisons right across clock wraparound
+    uint8_t next = NO_TASK;
+    uint32_t nextDeadline = 0;
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const Task& task = tasks[i];
+        if ((int32_t)(now - task.release) < 0) {
+            continue;
+        }
+        uint32_t deadline = task.release + task.deadline;
+        if (next == NO_TASK || (int32_t)(deadline - nextDeadline) < 0) {
+            next = i;
+            nextDeadline = deadline;
+        }
+    }
+    if (next == NO_TASK) {
+        return false;
+    }
+
+    Task& task = tasks[next];
+    uint32_t latency = now - task.release;
+    task.function();
+    uint32_t end = clock();
+
+    TaskStats& stats = task.stats;
+    stats.runs++;
+    if (latency > stats.maxLatencyUs) stats.maxLatencyUs = latency;
+    if (end - now > stats.maxRunUs) stats.maxRunUs = end - now;
+    if ((int32_t)(end - nextDeadline) > 0) stats.deadlineMisses++;
+
+    // Next release on the original grid, dropping any that already passed
+    task.release += task.period;
+    int32_t behind = (int32_t)(end - task.release);
+    if (behind >= (int32_t)task.period) {
+        uint32_t missed = (uint32_t)behind / task.period;
+        task.release += missed * task.period;
+        stats.skippedReleases += missed;
+    }
+    return true;
+}
+
+uint32_t TaskScheduler::idleTime() const {
+    if (taskCount == 0) {
+        return 0;
+    }
+
+    uint32_t now = clock();
+    uint32_t idle = 0xFFFFFFFF;
+    for (uint8_t i = 0; i < taskCount; i++) {
+        int32_t until = (int32_t)(tasks[i].release - now);
+        if (until <= 0) {
+            return 0;
+        }
+        if ((uint32_t)until < idle) idle = until;
+    }
+    return idle;
+}
+
+void TaskScheduler::resetStats() {
+    for (uint8_t i = 0; i < taskCount; i++) {
+        tasks[i].stats = TaskStats();
+    }
+}
@@ -0,0 +1,80 @@
+#include "UmpEncoder.h"
+
+static const uint8_t UTILITY_JR_TIMESTAMP = 0x2;
+static const uint8_t OPCODE_ASSIGNABLE_CONTROLLER = 0x3;
+static const uint8_t OPCODE_CONTROL_CHANGE = 0xB;
+static const uint8_t OPCODE_CHANNEL_PRESSURE = 0xD;
+static const uint8_t OPCODE_PITCH_BEND = 0xE;
+
+// First word of a channel voice message
+static uint32_t channelVoiceHeader(uint8_t type, uint8_t group, uint8_t opcode, uint8_t channel) {
+    return ((uint32_t)type << 28) | ((uint32_t)(group & 0x0F) << 24) |
+           ((uint32_t)opcode << 20) | ((uint32_t)((channel - 1) & 0x0F) << 16);
+}
+
+uint8_t UmpEncoder::jrTimestamp(uint32_t* out, uint32_t nowUs) {
+    // The 16-bit tick count wraps every ~2.1 s; receivers only use deltas
+    uint16_t ticks = (uint16_t)(nowUs / JR_TICK_US);
+    out[0] = ((uint32_t)TYPE_UTILITY << 28) | ((uint32_t)UTILITY_JR_TIMESTAMP << 20) | ticks;
+    return 1;
+}
+
+uint8_t UmpEncoder::controlChange(uint32_t* out, uint8_t group, uint8_t channel,
+                                  uint8_t control, uint32_t value) {
+    out[0] = channelVoiceHeader(TYPE_MIDI2_CHANNEL_VOICE, group, OPCODE_CONTROL_CHANGE, channel) |
+             ((uint32_t)(control & 0x7F) << 8);
+    out[1] = value;
+    return 2;
+}
+
+uint8_t UmpEncoder::assignableController(uint32_t* out, uint8_t group, uint8_t channel,
+                                         uint16_t parameter, uint32_t value) {
+    // Bank and index are the NRPN MSB and LSB
+    out[0] = channelVoiceHeader(TYPE_MIDI2_CHANNEL_VOICE, group, OPCODE_ASSIGNABLE_CONTROLLER, channel) |
+             ((uint32_t)((parameter >> 7) & 0x7F) << 8) | (parameter & 0x7F);
+    out[1] = value;
+    return 2;
+}
+
+uint8_t UmpEncoder::pitchBend(uint32_t* out, uint8_t group, uint8_t channel, uint32_t value) {
+    out[0] = channelVoiceHeader(TYPE_MIDI2_CHANNEL_VOICE, group, OPCODE_PITCH_BEND, channel);
+    out[1] = value;
+    return 2;
+}
+
+uint8_t UmpEncoder::channelPressure(uint32_t* out, uint8_t group, uint8_t channel, uint32_t value) {
+    out[0] = channelVoiceHeader(TYPE_MIDI2_CHANNEL_VOICE, group, OPCODE_CHANNEL_PRESSURE, channel);
+    out[1] = value;
+    return 2;
+}
+
+uint8_t UmpEncoder::midi1ControlChange(uint32_t* out, uint8_t group, uint8_t channel,
+                                       uint8_t control, uint8_t value) {
+    out[0] = channelVoiceHeader(TYPE_MIDI1_CHANNEL_VOICE, group, OPCODE_CONTROL_CHANGE, channel) |
+             ((uint32_t)(control & 0x7F) << 8) | (value & 0x7F);
+    return 1;
+}
+
+uint32_t UmpEncoder::scaleUp(uint32_t value, uint8_t sourceBits) {
+    uint8_t scaleBits = 32 - sourceBits;
+    uint32_t shifted = value << scaleBits;
+    uint32_t center = (uint32_t)1 << (sourceBits - 1);
+    if (value <= center) {
+        return shifted;
+    }
+
+    // Above center, fill the new low bits by repeating the source bits
+    // below its top bit, so full scale reaches full scale
+    uint8_t repeatBits = sourceBits - 1;
+    uint32_t repeat = value & ((1u << repeatBits) - 1);
+    if (scaleBits > repeatBits) {
+        repeat <<= scaleBits - repeatBits;
+    } else {
+        repeat >>= repeatBits - scaleBits;
+    }
+    while (repeat != 0) {
+        shifted |= repeat;
+        repeat >>= repeatBits;
+    }
+    return shifted;
+}
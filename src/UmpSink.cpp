@@ -0,0 +1,66 @@
+#include "UmpSink.h"
+#include "UmpEncoder.h"
+
+UmpSink::UmpSink(WriteFunction write, uint8_t group)
+    : write(write)
+    , group(group)
+    , timestamps(true)
+    , now(0)
+{
+}
+
+void UmpSink::controlChange(uint8_t control, uint8_t value, uint8_t channel) {
+    uint32_t words[MAX_WORDS];
+    uint8_t count = timestamps ? UmpEncoder::jrTimestamp(words, now) : 0;
+    count += UmpEncoder::controlChange(words + count, group, channel, control,
+                                       UmpEncoder::scaleUp(value & 0x7F, 7));
+    send(words, count);
+}
+
+void UmpSink::highResControl(uint8_t control, uint16_t value, uint8_t channel) {
+    // One 32-bit value on the MSB controller replaces the n/n+32 pair
+    uint32_t words[MAX_WORDS];
+    uint8_t count = timestamps ? UmpEncoder::jrTimestamp(words, now) : 0;
+    count += UmpEncoder::controlChange(words + count, group, channel, control,
+                                       UmpEncoder::scaleUp(value & 0x3FFF, 14));
+    send(words, count);
+}
+
+void UmpSink::nrpn(uint16_t parameter, uint16_t value, uint8_t channel) {
+    uint32_t words[MAX_WORDS];
+    uint8_t count = timestamps ? UmpEncoder::jrTimestamp(words, now) : 0;
+    count += UmpEncoder::assignableController(words + count, group, channel, parameter,
+                                              UmpEncoder::scaleUp(value & 0x3FFF, 14));
+    send(words, count);
+}
+
+void UmpSink::pitchBend(uint16_t value, uint8_t channel) {
+    // Min-center-max scaling keeps 8192 on the exact 32-bit center
+    uint32_t words[MAX_WORDS];
+    uint8_t count = timestamps ? UmpEncoder::jrTimestamp(words, now) : 0;
+    count += UmpEncoder::pitchBend(words + count, group, channel,
+                                   UmpEncoder::scaleUp(value & 0x3FFF, 14));
+    send(words, count);
+}
+
+void UmpSink::channelPressure(uint8_t value, uint8_t channel) {
+    uint32_t words[MAX_WORDS];
+    uint8_t count = timestamps ? UmpEncoder::jrTimestamp(words, now) : 0;
+    count += UmpEncoder::channelPressure(words + count, group, channel,
+                                         UmpEncoder::scaleUp(value & 0x7F, 7));
+    send(words, count);
+}
+
+void UmpSink::send(uint32_t* words, uint8_t count) {
+    queue.push(words, count, stamp);
+}
+
+void UmpSink::flush() {
+    UsbPacketQueue::Message message;
+    while (queue.pop(message)) {
+        if (write) {
+            write(message.words, message.count);
+        }
+        handedOff(message.stamp);
+    }
+}
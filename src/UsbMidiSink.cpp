@@ -0,0 +1,84 @@
+#include "UsbMidiSink.h"
+
+UsbMidiSink::UsbMidiSink(WriteFunction write)
+    : write(write)
+    , reselect(false)
+{
+    resetNrpnSelection();
+}
+
+uint32_t UsbMidiSink::packet(uint8_t status, uint8_t data1, uint8_t data2, uint8_t channel) {
+    // Code index number (the status nibble) in the low byte, then the
+    // MIDI bytes in wire order
+    status = (status & 0xF0) | ((channel - 1) & 0x0F);
+    return (uint32_t)(status >> 4) | (uint32_t)status << 8 |
+           (uint32_t)(data1 & 0x7F) << 16 | (uint32_t)(data2 & 0x7F) << 24;
+}
+
+void UsbMidiSink::controlChange(uint8_t control, uint8_t value, uint8_t channel) {
+    uint32_t words[] = {packet(0xB0, control, value, channel)};
+    send(words, 1);
+}
+
+void UsbMidiSink::highResControl(uint8_t control, uint16_t value, uint8_t channel) {
+    uint32_t words[] = {
+        packet(0xB0, control, value >> 7, channel),
+        packet(0xB0, control + 32, value & 0x7F, channel)
+    };
+    send(words, 2);
+}
+
+void UsbMidiSink::nrpn(uint16_t parameter, uint16_t value, uint8_t channel) {
+    // The selection is only touched here, in the sending context
+    if (reselect) {
+        reselect = false;
+        resetNrpnSelection();
+    }
+    uint16_t& selected = selectedParameter[(channel - 1) & 0x0F];
+    uint32_t words[UsbPacketQueue::MAX_WORDS];
+    uint8_t count = 0;
+    bool select = selected != parameter;
+    if (select) {
+        words[count++] = packet(0xB0, 99, parameter >> 7, channel);
+        words[count++] = packet(0xB0, 98, parameter & 0x7F, channel);
+    }
+    words[count++] = packet(0xB0, 6, value >> 7, channel);
+    words[count++] = packet(0xB0, 38, value & 0x7F, channel);
+
+    // A dropped select must be sent again with the next value
+    if (queue.push(words, count, stamp)) {
+        selected = parameter;
+    } else if (select) {
+        selected = NO_PARAMETER;
+    }
+}
+
+void UsbMidiSink::pitchBend(uint16_t value, uint8_t channel) {
+    uint32_t words[] = {packet(0xE0, value & 0x7F, value >> 7, channel)};
+    send(words, 1);
+}
+
+void UsbMidiSink::channelPressure(uint8_t value, uint8_t channel) {
+    uint32_t words[] = {packet(0xD0, value, 0, channel)};
+    send(words, 1);
+}
+
+void UsbMidiSink::send(const uint32_t* words, uint8_t count) {
+    queue.push(words, count, stamp);
+}
+
+void UsbMidiSink::flush() {
+    UsbPacketQueue::Message message;
+    while (queue.pop(message)) {
+        if (write) {
+            write(message.words, message.count);
+        }
+        handedOff(message.stamp);
+    }
+}
+
+void UsbMidiSink::resetNrpnSelection() {
+    for (uint8_t i = 0; i < 16; i++) {
+        selectedParameter[i] = NO_PARAMETER;
+    }
+}
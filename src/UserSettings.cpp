@@ -12,17 +12,15 @@ void UserSettings::begin() {
 }
 
 void UserSettings::loadFromEEPROM() {
-  EEPROM.get(ADDR_CAL_BREATH, calBreath);
-  EEPROM.get(ADDR_CAL_PINCH, calPinch);
-  EEPROM.get(ADDR_CAL_EXP, calExp);
-  EEPROM.get(ADDR_CAL_TILT, calTilt);
-  EEPROM.get(ADDR_CAL_NOD, calNod);
-  
-  EEPROM.get(ADDR_BREATH_CC, breathCC);
-  EEPROM.get(ADDR_PINCH_CC, pinchCC);
-  EEPROM.get(ADDR_EXP_CC, expCC);
-  EEPROM.get(ADDR_TILT_CC, tiltCC);
-  EEPROM.get(ADDR_NOD_CC, nodCC);
+  for (uint8_t i = 0; i < CHANNELS; i++) {
+    EEPROM.get(ADDR_CAL + i * sizeof(float), cal[i]);
+    EEPROM.get(ADDR_CC + i, cc[i]);
+    EEPROM.get(ADDR_CURVE + i, curve[i]);
+    EEPROM.get(ADDR_FLOOR + i * sizeof(float), floor[i]);
+    EEPROM.get(ADDR_CEILING + i * sizeof(float), ceiling[i]);
+    EEPROM.get(ADDR_RESOLUTION + i, resolution[i]);
+  }
+  validateResolutions();
   
   EEPROM.get(ADDR_SCREEN_SLEEP, screenSleep);
   EEPROM.get(ADDR_DISPLAY_BRIGHTNESS, displayBrightness);
@@ -30,37 +28,63 @@ void UserSettings::loadFromEEPROM() {
   EEPROM.get(ADDR_USB_MIDI_EN, usbMidiEnabled);
   EEPROM.get(ADDR_HW_MIDI_EN, hwMidiEnabled);
   
-  EEPROM.get(ADDR_BREATH_CURVE, breathCurve);
-  EEPROM.get(ADDR_PINCH_CURVE, pinchCurve);
-  EEPROM.get(ADDR_EXP_CURVE, expCurve);
-  EEPROM.get(ADDR_TILT_CURVE, tiltCurve);
-  EEPROM.get(ADDR_NOD_CURVE, nodCurve);
+  EEPROM.get(ADDR_ACTIVE_SAMPLE_RATE, activeSampleRate);
+  EEPROM.get(ADDR_IDLE_SAMPLE_RATE, idleSampleRate);
+  EEPROM.get(ADDR_ACTIVITY_BREATH, activityBreathThreshold);
+  EEPROM.get(ADDR_ACTIVITY_MOTION, activityMotionThreshold);
+  EEPROM.get(ADDR_IDLE_TIMEOUT, idleTimeout);
+  EEPROM.get(ADDR_IDLE_IMU_INTERVAL, idleImuInterval);
+  validateSampling();
   
-  EEPROM.get(ADDR_BREATH_FLOOR, breathFloor);
-  EEPROM.get(ADDR_PINCH_FLOOR, pinchFloor);
-  EEPROM.get(ADDR_EXP_FLOOR, expFloor);
-  EEPROM.get(ADDR_TILT_FLOOR, tiltFloor);
-  EEPROM.get(ADDR_NOD_FLOOR, nodFloor);
+  for (uint8_t i = 0; i < MOD_SLOTS; i++) {
+    EEPROM.get(ADDR_MOD_SLOTS + i * sizeof(ModSlot), modSlots[i]);
+  }
+  validateModSlots();
   
-  EEPROM.get(ADDR_BREATH_CEILING, breathCeiling);
-  EEPROM.get(ADDR_PINCH_CEILING, pinchCeiling);
-  EEPROM.get(ADDR_EXP_CEILING, expCeiling);
-  EEPROM.get(ADDR_TILT_CEILING, tiltCeiling);
-  EEPROM.get(ADDR_NOD_CEILING, nodCeiling);
+  for (uint8_t i = 0; i < USER_CURVES; i++) {
+    EEPROM.get(ADDR_USER_CURVES + i * sizeof(CurvePoints), userCurves[i]);
+  }
+  validateUserCurves();
+  revision++;
+}
+
+// EEPROM saved by older firmware has 0xFF in these addresses
+void UserSettings::validateSampling() {
+  if (activeSampleRate < 1000 || activeSampleRate > 10000) activeSampleRate = 8000;
+  if (idleSampleRate < 1000 || idleSampleRate > activeSampleRate) idleSampleRate = 1000;
+  if (!(activityBreathThreshold > 0.0 && activityBreathThreshold <= 1.0)) activityBreathThreshold = 0.02;
+  if (!(activityMotionThreshold > 0.0 && activityMotionThreshold <= 2000.0)) activityMotionThreshold = 20.0;
+  if (idleTimeout < 100 || idleTimeout > 60000) idleTimeout = 2000;
+  if (idleImuInterval < 10 || idleImuInterval > 200) idleImuInterval = 50;
+}
+
+void UserSettings::validateResolutions() {
+  for (uint8_t i = 0; i < CHANNELS; i++) {
+    if (resolution[i] >= (uint8_t)CcResolution::COUNT) resolution[i] = 0;
+  }
+}
+
+void UserSettings::validateModSlots() {
+  for (uint8_t i = 0; i < MOD_SLOTS; i++) {
+    if (!modSlots[i].isValid()) modSlots[i] = ModSlot();
+  }
+}
+
+void UserSettings::validateUserCurves() {
+  for (uint8_t i = 0; i < USER_CURVES; i++) {
+    if (!userCurves[i].isValid()) userCurves[i] = SplineCurve::linear();
+  }
 }
 
 void UserSettings::saveAll() {
-  EEPROM.put(ADDR_CAL_BREATH, calBreath);
-  EEPROM.put(ADDR_CAL_PINCH, calPinch);
-  EEPROM.put(ADDR_CAL_EXP, calExp);
-  EEPROM.put(ADDR_CAL_TILT, calTilt);
-  EEPROM.put(ADDR_CAL_NOD, calNod);
-  
-  EEPROM.put(ADDR_BREATH_CC, breathCC);
-  EEPROM.put(ADDR_PINCH_CC, pinchCC);
-  EEPROM.put(ADDR_EXP_CC, expCC);
-  EEPROM.put(ADDR_TILT_CC, tiltCC);
-  EEPROM.put(ADDR_NOD_CC, nodCC);
+  for (uint8_t i = 0; i < CHANNELS; i++) {
+    EEPROM.put(ADDR_CAL + i * sizeof(float), cal[i]);
+    EEPROM.put(ADDR_CC + i, cc[i]);
+    EEPROM.put(ADDR_CURVE + i, curve[i]);
+    EEPROM.put(ADDR_FLOOR + i * sizeof(float), floor[i]);
+    EEPROM.put(ADDR_CEILING + i * sizeof(float), ceiling[i]);
+    EEPROM.put(ADDR_RESOLUTION + i, resolution[i]);
+  }
   
   EEPROM.put(ADDR_SCREEN_SLEEP, screenSleep);
   EEPROM.put(ADDR_DISPLAY_BRIGHTNESS, displayBrightness);
@@ -68,23 +92,20 @@ void UserSettings::saveAll() {
   EEPROM.put(ADDR_USB_MIDI_EN, usbMidiEnabled);
   EEPROM.put(ADDR_HW_MIDI_EN, hwMidiEnabled);
   
-  EEPROM.put(ADDR_BREATH_CURVE, breathCurve);
-  EEPROM.put(ADDR_PINCH_CURVE, pinchCurve);
-  EEPROM.put(ADDR_EXP_CURVE, expCurve);
-  EEPROM.put(ADDR_TILT_CURVE, tiltCurve);
-  EEPROM.put(ADDR_NOD_CURVE, nodCurve);
+  EEPROM.put(ADDR_ACTIVE_SAMPLE_RATE, activeSampleRate);
+  EEPROM.put(ADDR_IDLE_SAMPLE_RATE, idleSampleRate);
+  EEPROM.put(ADDR_ACTIVITY_BREATH, activityBreathThreshold);
+  EEPROM.put(ADDR_ACTIVITY_MOTION, activityMotionThreshold);
+  EEPROM.put(ADDR_IDLE_TIMEOUT, idleTimeout);
+  EEPROM.put(ADDR_IDLE_IMU_INTERVAL, idleImuInterval);
   
-  EEPROM.put(ADDR_BREATH_FLOOR, breathFloor);
-  EEPROM.put(ADDR_PINCH_FLOOR, pinchFloor);
-  EEPROM.put(ADDR_EXP_FLOOR, expFloor);
-  EEPROM.put(ADDR_TILT_FLOOR, tiltFloor);
-  EEPROM.put(ADDR_NOD_FLOOR, nodFloor);
+  for (uint8_t i = 0; i < MOD_SLOTS; i++) {
+    EEPROM.put(ADDR_MOD_SLOTS + i * sizeof(ModSlot), modSlots[i]);
+  }
   
-  EEPROM.put(ADDR_BREATH_CEILING, breathCeiling);
-  EEPROM.put(ADDR_PINCH_CEILING, pinchCeiling);
-  EEPROM.put(ADDR_EXP_CEILING, expCeiling);
-  EEPROM.put(ADDR_TILT_CEILING, tiltCeiling);
-  EEPROM.put(ADDR_NOD_CEILING, nodCeiling);
+  for (uint8_t i = 0; i < USER_CURVES; i++) {
+    EEPROM.put(ADDR_USER_CURVES + i * sizeof(CurvePoints), userCurves[i]);
+  }
   
   // Write magic and version LAST - if power is lost during save,
   // next boot will see invalid magic and reset to defaults
@@ -93,17 +114,14 @@ void UserSettings::saveAll() {
 }
 
 void UserSettings::resetToDefaults() {
-  calBreath = 1.0;
-  calPinch = 1.0;
-  calExp = 1.0;
-  calTilt = 1.0;
-  calNod = 1.0;
-  
-  breathCC = 1;
-  pinchCC = 2;
-  expCC = 3;
-  tiltCC = 4;
-  nodCC = 5;
+  for (uint8_t i = 0; i < CHANNELS; i++) {
+    cal[i] = 1.0;
+    cc[i] = i + 1;
+    curve[i] = 1;
+    floor[i] = 0.0;
+    ceiling[i] = 1.0;
+    resolution[i] = 0;
+  }
   
   screenSleep = 30;
   displayBrightness = 176; // Default to level 7 (26 + 6*25 = 176)
@@ -111,84 +129,88 @@ void UserSettings::resetToDefaults() {
   usbMidiEnabled = true;
   hwMidiEnabled = true;
   
-  breathCurve = 1;
-  pinchCurve = 1;
-  expCurve = 1;
-  tiltCurve = 1;
-  nodCurve = 1;
+  activeSampleRate = 8000;
+  idleSampleRate = 1000;
+  activityBreathThreshold = 0.02;
+  activityMotionThreshold = 20.0;
+  idleTimeout = 2000;
+  idleImuInterval = 50;
   
-  breathFloor = 0.0;
-  breathCeiling = 1.0;
-  pinchFloor = 0.0;
-  pinchCeiling = 1.0;
-  expFloor = 0.0;
-  expCeiling = 1.0;
-  tiltFloor = 0.0;
-  tiltCeiling = 1.0;
-  nodFloor = 0.0;
-  nodCeiling = 1.0;
+  for (uint8_t i = 0; i < MOD_SLOTS; i++) {
+    modSlots[i] = ModSlot();
+  }
+  for (uint8_t i = 0; i < USER_CURVES; i++) {
+    userCurves[i] = SplineCurve::linear();
+  }
+  revision++;
   
   saveAll();
 }
 
-void UserSettings::setCalBreath(float value) {
-  calBreath = value;
-  EEPROM.put(ADDR_CAL_BREATH, calBreath);
-}
-
-void UserSettings::setCalPinch(float value) {
-  calPinch = value;
-  EEPROM.put(ADDR_CAL_PINCH, calPinch);
-}
-
-void UserSettings::setCalExp(float value) {
-  calExp = value;
-  EEPROM.put(ADDR_CAL_EXP, calExp);
-}
-
-void UserSettings::setCalTilt(float value) {
-  calTilt = value;
-  EEPROM.put(ADDR_CAL_TILT, calTilt);
-}
-
-void UserSettings::setCalNod(float value) {
-  calNod = value;
-  EEPROM.put(ADDR_CAL_NOD, calNod);
+void UserSettings::setCal(SensorChannel channel, float value) {
+  uint8_t i = (uint8_t)channel;
+  if (i < CHANNELS) {
+    cal[i] = value;
+    revision++;
+    EEPROM.put(ADDR_CAL + i * sizeof(float), cal[i]);
+  }
 }
 
-void UserSettings::setBreathCC(int value) {
-  breathCC = value;
-  EEPROM.put(ADDR_BREATH_CC, breathCC);
+void UserSettings::setCurve(SensorChannel channel, int value) {
+  uint8_t i = (uint8_t)channel;
+  if (i < CHANNELS && value >= 1 && value <= CURVE_SETTING_MAX) {
+    curve[i] = value;
+    revision++;
+    EEPROM.put(ADDR_CURVE + i, curve[i]);
+  }
 }
 
-void UserSettings::setPinchCC(int value) {
-  pinchCC = value;
-  EEPROM.put(ADDR_PINCH_CC, pinchCC);
+void UserSettings::setFloor(SensorChannel channel, float value) {
+  uint8_t i = (uint8_t)channel;
+  if (i < CHANNELS && value >= 0.0 && value <= 1.0) {
+    floor[i] = value;
+    revision++;
+    EEPROM.put(ADDR_FLOOR + i * sizeof(float), floor[i]);
+  }
 }
 
-void UserSettings::setExpCC(int value) {
-  expCC = value;
-  EEPROM.put(ADDR_EXP_CC, expCC);
+void UserSettings::setCeiling(SensorChannel channel, float value) {
+  uint8_t i = (uint8_t)channel;
+  if (i < CHANNELS && value >= 0.0 && value <= 1.0) {
+    ceiling[i] = value;
+    revision++;
+    EEPROM.put(ADDR_CEILING + i * sizeof(float), ceiling[i]);
+  }
 }
 
-void UserSettings::setTiltCC(int value) {
-  tiltCC = value;
-  EEPROM.put(ADDR_TILT_CC, tiltCC);
+void UserSettings::setCC(SensorChannel channel, int value) {
+  uint8_t i = (uint8_t)channel;
+  if (i < CHANNELS) {
+    cc[i] = value;
+    revision++;
+    EEPROM.put(ADDR_CC + i, cc[i]);
+  }
 }
 
-void UserSettings::setNodCC(int value) {
-  nodCC = value;
-  EEPROM.put(ADDR_NOD_CC, nodCC);
+void UserSettings::setResolution(SensorChannel channel, CcResolution value) {
+  uint8_t i = (uint8_t)channel;
+  if (i < CHANNELS && value < CcResolution::COUNT) {
+    resolution[i] = (uint8_t)value;
+    revision++;
+    EEPROM.put(ADDR_RESOLUTION + i, resolution[i]);
+  }
 }
 
 void UserSettings::setScreenSleep(int value) {
   screenSleep = value;
+  revision++;
   EEPROM.put(ADDR_SCREEN_SLEEP, screenSleep);
 }
 
 void UserSettings::setDisplayBrightness(int value) {
   if (value >= 0 && value <= 255) {
     displayBrightness = value;
+    revision++;
     EEPROM.put(ADDR_DISPLAY_BRIGHTNESS, displayBrightness);
   }
 }
@@ -196,121 +218,95 @@ void UserSettings::setDisplayBrightness(int value) {
 void UserSettings::setMidiChannel(int value) {
   if (value >= 1 && value <= 16) {
     midiChannel = value;
+    revision++;
     EEPROM.put(ADDR_MIDI_CHANNEL, midiChannel);
   }
 }
 
 void UserSettings::setUsbMidiEnabled(bool enabled) {
   usbMidiEnabled = enabled;
+  revision++;
   EEPROM.put(ADDR_USB_MIDI_EN, usbMidiEnabled);
 }
 
 void UserSettings::setHwMidiEnabled(bool enabled) {
   hwMidiEnabled = enabled;
+  revision++;
   EEPROM.put(ADDR_HW_MIDI_EN, hwMidiEnabled);
 }
 
-void UserSettings::setBreathCurve(int value) {
-  if (value >= 1 && value <= 10) {
-    breathCurve = value;
-    EEPROM.put(ADDR_BREATH_CURVE, breathCurve);
+void UserSettings::setActiveSampleRate(int value) {
+  if (value >= 1000 && value <= 10000) {
+    activeSampleRate = value;
+    revision++;
+    EEPROM.put(ADDR_ACTIVE_SAMPLE_RATE, activeSampleRate);
   }
 }
 
-void UserSettings::setPinchCurve(int value) {
-  if (value >= 1 && value <= 10) {
-    pinchCurve = value;
-    EEPROM.put(ADDR_PINCH_CURVE, pinchCurve);
+void UserSettings::setIdleSampleRate(int value) {
+  if (value >= 1000 && value <= activeSampleRate) {
+    idleSampleRate = value;
+    revision++;
+    EEPROM.put(ADDR_IDLE_SAMPLE_RATE, idleSampleRate);
   }
 }
 
-void UserSettings::setExpCurve(int value) {
-  if (value >= 1 && value <= 10) {
-    expCurve = value;
-    EEPROM.put(ADDR_EXP_CURVE, expCurve);
+void UserSettings::setActivityBreathThreshold(float value) {
+  if (value > 0.0 && value <= 1.0) {
+    activityBreathThreshold = value;
+    revision++;
+    EEPROM.put(ADDR_ACTIVITY_BREATH, activityBreathThreshold);
   }
 }
 
-void UserSettings::setTiltCurve(int value) {
-  if (value >= 1 && value <= 10) {
-    tiltCurve = value;
-    EEPROM.put(ADDR_TILT_CURVE, tiltCurve);
+void UserSettings::setActivityMotionThreshold(float value) {
+  if (value > 0.0 && value <= 2000.0) {
+    activityMotionThreshold = value;
+    revision++;
+    EEPROM.put(ADDR_ACTIVITY_MOTION, activityMotionThreshold);
   }
 }
 
-void UserSettings::setNodCurve(int value) {
-  if (value >= 1 && value <= 10) {
-    nodCurve = value;
-    EEPROM.put(ADDR_NOD_CURVE, nodCurve);
+void UserSettings::setIdleTimeout(int value) {
+  if (value >= 100 && value <= 60000) {
+    idleTimeout = value;
+    revision++;
+    EEPROM.put(ADDR_IDLE_TIMEOUT, idleTimeout);
   }
 }
 
-void UserSettings::setBreathFloor(float value) {
-  if (value >= 0.0 && value <= 1.0) {
-    breathFloor = value;
-    EEPROM.put(ADDR_BREATH_FLOOR, breathFloor);
+void UserSettings::setIdleImuInterval(int value) {
+  if (value >= 10 && value <= 200) {
+    idleImuInterval = value;
+    revision++;
+    EEPROM.put(ADDR_IDLE_IMU_INTERVAL, idleImuInterval);
   }
 }
 
-void UserSettings::setPinchFloor(float value) {
-  if (value >= 0.0 && value <= 1.0) {
-    pinchFloor = value;
-    EEPROM.put(ADDR_PINCH_FLOOR, pinchFloor);
+void UserSettings::setModSlot(uint8_t slot, const ModSlot& value) {
+  if (slot < MOD_SLOTS && value.isValid()) {
+    modSlots[slot] = value;
+    revision++;
+    EEPROM.put(ADDR_MOD_SLOTS + slot * sizeof(ModSlot), modSlots[slot]);
   }
 }
 
-void UserSettings::setExpFloor(float value) {
-  if (value >= 0.0 && value <= 1.0) {
-    expFloor = value;
-    EEPROM.put(ADDR_EXP_FLOOR, expFloor);
+void UserSettings::resetModSlots() {
+  for (uint8_t i = 0; i < MOD_SLOTS; i++) {
+    setModSlot(i, ModSlot());
   }
 }
 
-void UserSettings::setTiltFloor(float value) {
-  if (value >= 0.0 && value <= 1.0) {
-    tiltFloor = value;
-    EEPROM.put(ADDR_TILT_FLOOR, tiltFloor);
+void UserSettings::setUserCurve(uint8_t index, const CurvePoints& points) {
+  if (index < USER_CURVES) {
+    userCurves[index] = points;
+    revision++;
+    EEPROM.put(ADDR_USER_CURVES + index * sizeof(CurvePoints), userCurves[index]);
   }
 }
 
-void UserSettings::setNodFloor(float value) {
-  if (value >= 0.0 && value <= 1.0) {
-    nodFloor = value;
-    EEPROM.put(ADDR_NOD_FLOOR, nodFloor);
+void UserSettings::resetUserCurves() {
+  for (uint8_t i = 0; i < USER_CURVES; i++) {
+    setUserCurve(i, SplineCurve::linear());
   }
 }
-
-void UserSettings::setBreathCeiling(float value) {
-  if (value >= 0.0 && value <= 1.0) {
-    breathCeiling = value;
-    EEPROM.put(ADDR_BREATH_CEILING, breathCeiling);
-  }
-}
-
-void UserSettings::setPinchCeiling(float value) {
-  if (value >= 0.0 && value <= 1.0) {
-    pinchCeiling = value;
-    EEPROM.put(ADDR_PINCH_CEILING, pinchCeiling);
-  }
-}
-
-void UserSettings::setExpCeiling(float value) {
-  if (value >= 0.0 && value <= 1.0) {
-    expCeiling = value;
-    EEPROM.put(ADDR_EXP_CEILING, expCeiling);
-  }
-}
-
-void UserSettings::setTiltCeiling(float value) {
-  if (value >= 0.0 && value <= 1.0) {
-    tiltCeiling = value;
-    EEPROM.put(ADDR_TILT_CEILING, tiltCeiling);
-  }
-}
-
-void UserSettings::setNodCeiling(float value) {
-  if (value >= 0.0 && value <= 1.0) {
-    nodCeiling = value;
-    EEPROM.put(ADDR_NOD_CEILING, nodCeiling);
-  }
-}
\ No newline at end of file
@@ -11,111 +11,467 @@ add ribs to bosses
 #include "DisplayHandler.h"
 #include "UserSettings.h"
 #include "ButtonHandler.h"
+#include "ResponseMapper.h"
+#include "SignalChain.h"
+#include "CcTransmitter.h"
+#include "DinScheduler.h"
+#include "UsbMidiSink.h"
+#include "UmpSink.h"
+#include "TaskScheduler.h"
+#include "CadenceMonitor.h"
+#include "LatencyHistogram.h"
+#include "CycleProfiler.h"
+#include "SeqLock.h"
 
 MIDI_CREATE_INSTANCE(HardwareSerial, Serial5, hwMIDI);
 
+const unsigned long CC_REFRESH_INTERVAL = 2000; // ms, resend unchanged CCs for late joiners
+
+// Sensor -> curve -> MIDI runs in its own interrupt at a fixed rate. Nothing
+// in it waits on a driver, so it can sit above USB, I2C and the other
+// peripherals; only the sampling timer and the DIN UART go ahead of it.
+const uint32_t CONTROL_PERIOD_US = 1000;      // 1 kHz control rate
+const uint32_t CONTROL_TOLERANCE_US = 50;     // cadence error counted as late
+const uint8_t CONTROL_IRQ_PRIORITY = 80;      // above USB (112), LPI2C (96) and the default 128
+const uint8_t SAMPLING_IRQ_PRIORITY = 48;     // PIT, shared by AnalogSampler and the control timer
+
+// Background task periods in microseconds; loop() does rendering and EEPROM
+const uint32_t USB_PERIOD_US = 1000;          // 1 kHz, write out queued USB MIDI
+const uint32_t IMU_BUS_PERIOD_US = 10000;     // 100 Hz, reset the IMU bus when it failed
+const uint32_t SETTINGS_PERIOD_US = 10000;    // 100 Hz, rebuild tables after edits
+const uint32_t UI_PERIOD_US = 10000;          // 100 Hz, also drains button events
+const uint32_t SERIAL_PERIOD_US = 20000;      // 50 Hz, diagnostic commands
+
 SensorCache sensors;
 UserSettings settings;
 DisplayHandler display(sensors, settings);
+// Two matrices of nine 8 KB tables, about 148 KB: kept in RAM2 so they
+// don't crowd the DTCM that holds the stack and the other globals. The
+// control interrupt reads a couple of entries per route per tick, which
+// the data cache absorbs.
+DMAMEM ResponseMapper responses(settings);
+DinScheduler dinOut(
+  [](){return Serial5.availableForWrite();},
+  [](const uint8_t* data, uint8_t length){Serial5.write(data, length);});
+// The USB sink queues in the control interrupt and writes from loop(), so a
+// host that stops reading only stalls the writer task
+void writeUsbPackets(const uint32_t* words, uint8_t count){
+  for (uint8_t i = 0; i < count; i++) {
+    usb_midi_write_packed(words[i]);
+  }
+}
+#ifdef MIDI2_UMP_OUTPUT
+// MIDI 2.0 packets onto the USB MIDI endpoint. Only for a Teensy core whose
+// USB descriptor offers the UMP alternate setting; the stock core
+// enumerates MIDI 1.0, where the host would misread these words.
+UmpSink usbOut(writeUsbPackets);
+#else
+UsbMidiSink usbOut(writeUsbPackets);
+#endif
+CcTransmitter ccOut(usbOut, dinOut);
+uint32_t matrixRevision = 0;
+
+// What the control interrupt needs from UserSettings. loop() owns the
+// settings and publishes this copy whenever they change; the interrupt
+// keeps its own copy and only takes a new one that was not mid-write.
+struct DinPriority {
+  uint8_t control;
+  uint8_t priority;
+};
+
+struct ControlSettings {
+  uint32_t revision;
+  uint8_t midiChannel;
+  bool usbMidiEnabled;
+  bool hwMidiEnabled;
+  uint8_t dinPriorityCount;
+  DinPriority dinPriorities[UserSettings::MOD_SLOTS + UserSettings::CHANNELS];
+};
+
+SeqLock<ControlSettings> publishedSettings;
+ControlSettings controlSettings; // the interrupt's copy
 ButtonHandler buttonUp(upButtonPin, [](){display.pressUp();});
 ButtonHandler buttonDown(downButtonPin, [](){display.pressDown();});
 ButtonHandler buttonLeft(leftButtonPin, [](){display.pressLeft();});
 ButtonHandler buttonRight(rightButtonPin, [](){display.pressRight();});
+TaskScheduler scheduler([](){return (uint32_t)micros();});
+const char* const taskNames[] = {"USB", "IMU bus", "Settings", "Display", "Serial"}; // in addTask order
+IntervalTimer controlTimer;
+CadenceMonitor cadence(CONTROL_PERIOD_US, CONTROL_TOLERANCE_US);
+LatencyHistogram portLatency[(uint8_t)MidiPort::COUNT]; // sensor sample to port handoff
+CycleProfiler profiler([](){return (uint32_t)ARM_DWT_CYCCNT;}, F_CPU_ACTUAL); // one-second windows at the running core clock
 
+// Profiled sections, added to the profiler in this order in setup()
+enum ProfileSection : uint8_t {
+  PROFILE_CONTROL,   // whole control tick, overruns are ticks longer than the period
+  PROFILE_SENSORS,
+  PROFILE_CURVES,
+  PROFILE_MIDI_SEND, // each routed message
+  PROFILE_DIN,
+  PROFILE_DISPLAY
+};
+
+// Control interrupt
+void controlTimerISR();
+void controlISR();
+
+// Background tasks
+void applySettings();
+void serviceSerial();
+void serviceUsb();
+
+// Latency diagnostics
+LatencySummary readLatency(uint8_t port);
+void resetLatency();
+SectionProfile readProfile(uint8_t section);
+void resetProfile();
 
 void setup() {
   Serial.begin(115200);
   display.begin();  // Show loading screen first
   settings.begin();
   sensors.begin();  // IMU autoOffsets happens during loading screen
+  sensors.setImuMode(ImuMode::ASYNC);  // IMU reads never block the loop
+  sensors.setImuDataReadyMode(true);   // Read when the IMU has a new sample
+  
+  // Full rate while playing, slow down when breath and motion go quiet
+  AdaptiveSamplingConfig sampling;
+  sampling.activeRateHz = settings.getActiveSampleRate();
+  sampling.idleRateHz = settings.getIdleSampleRate();
+  sampling.breathThreshold = settings.getActivityBreathThreshold();
+  sampling.motionThreshold = settings.getActivityMotionThreshold();
+  sampling.idleTimeout = settings.getIdleTimeout();
+  sampling.idleImuInterval = settings.getIdleImuInterval();
+  sensors.setAdaptiveSampling(sampling);
   
   hwMIDI.begin(MIDI_CHANNEL_OMNI);
+  ccOut.setRefreshInterval(CC_REFRESH_INTERVAL);
+  
+  // DIN hands off inside the control interrupt, USB from its writer task in
+  // loop(); each histogram has a single writer
+  usbOut.setHandoffFunction([](uint32_t stamp){
+    portLatency[(uint8_t)MidiPort::USB].record((ARM_DWT_CYCCNT - stamp) / (F_CPU_ACTUAL / 1000000));
+  });
+  dinOut.setHandoffFunction([](uint32_t stamp){
+    portLatency[(uint8_t)MidiPort::DIN].record((ARM_DWT_CYCCNT - stamp) / (F_CPU_ACTUAL / 1000000));
+  });
+  display.setLatencySource(readLatency, resetLatency);
+  
+  uint32_t cyclesPerUs = F_CPU_ACTUAL / 1000000;
+  profiler.addSection("Control", CONTROL_PERIOD_US * cyclesPerUs);
+  profiler.addSection("Sensors");
+  profiler.addSection("Curves");
+  profiler.addSection("MIDI send");
+  profiler.addSection("DIN");
+  profiler.addSection("Display", UI_PERIOD_US * cyclesPerUs);
+  display.setProfileSource(readProfile, profiler.getSectionCount(), resetProfile);
+  
+  // Tables must exist before the first control tick
+  applySettings();
+  
+  // Buttons queue edges from their pin interrupts; the display drains them
+  ButtonHandler::begin();
+  
+  scheduler.addTask(serviceUsb, USB_PERIOD_US);
+  scheduler.addTask([](){sensors.serviceImuBus();}, IMU_BUS_PERIOD_US);
+  scheduler.addTask(applySettings, SETTINGS_PERIOD_US);
+  scheduler.addTask([](){
+    uint32_t cycles = profiler.start();
+    display.update();
+    profiler.stop(PROFILE_DISPLAY, cycles);
+  }, UI_PERIOD_US);
+  scheduler.addTask(serviceSerial, SERIAL_PERIOD_US);
+  
+  // The PIT interrupt is shared with AnalogSampler, so the timer only pends
+  // the software interrupt that runs the control path
+  attachInterruptVector(IRQ_SOFTWARE, controlISR);
+  NVIC_SET_PRIORITY(IRQ_SOFTWARE, CONTROL_IRQ_PRIORITY);
+  NVIC_ENABLE_IRQ(IRQ_SOFTWARE);
+  controlTimer.begin(controlTimerISR, CONTROL_PERIOD_US);
+  // The PIT priority is the highest any of its timers asks for
+  controlTimer.priority(SAMPLING_IRQ_PRIORITY);
 }
 
-// Apply curve, floor, and ceiling to sensor value
-float applyCurve(float input, int curveType, float floor, float ceiling) {
-  // Constrain to 0-1 range first
-  input = constrain(input, 0.0, 1.0);
-  
-  // Apply floor/ceiling trimming
-  float output;
-  if (input < floor) {
-    output = 0.0;
-  } else if (input > ceiling) {
-    output = 1.0;
-  } else {
-    // Map input range to 0-1
-    float mappedInput = (input - floor) / (ceiling - floor);
-    
-    // Apply curve type: 1=linear, 2=concave, 3=convex, 4=s-curve
-    if (curveType == 1) {
-      // Linear
-      output = mappedInput;
-    } else if (curveType == 2) {
-      // Concave (ease-in)
-      output = mappedInput * mappedInput;
-    } else if (curveType == 3) {
-      // Convex (ease-out)
-      output = sqrt(mappedInput);
-    } else {
-      // S-curve (ease-in-out)
-      output = mappedInput * mappedInput * (3.0 - 2.0 * mappedInput);
-    }
+// Writes out the USB messages queued by the control interrupt. A host that
+// (re)configures the device has not seen the NRPN selects, so those go out
+// again with the next values.
+void serviceUsb() {
+  static uint8_t configuration = 0;
+  if (usb_configuration != configuration) {
+    configuration = usb_configuration;
+    if (configuration) usbOut.refresh();
+  }
+  usbOut.flush();
+}
+
+// Runs in loop(). DIN has ~3 kB/s, so breath goes first when the wire is busy;
+// later entries override earlier ones for the same control.
+void publishControlSettings() {
+  ControlSettings next;
+  next.revision = settings.getRevision();
+  next.midiChannel = settings.getMidiChannel();
+  next.usbMidiEnabled = settings.getUsbMidiEnabled();
+  next.hwMidiEnabled = settings.getHwMidiEnabled();
+  
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < UserSettings::MOD_SLOTS; i++) {
+    next.dinPriorities[count++] = {settings.getModSlot(i).number, 2};
   }
+  next.dinPriorities[count++] = {(uint8_t)settings.getCC(SensorChannel::TILT), 2};
+  next.dinPriorities[count++] = {(uint8_t)settings.getCC(SensorChannel::NOD), 2};
+  next.dinPriorities[count++] = {(uint8_t)settings.getCC(SensorChannel::PINCH), 1};
+  next.dinPriorities[count++] = {(uint8_t)settings.getCC(SensorChannel::EXPRESSION), 1};
+  next.dinPriorities[count++] = {(uint8_t)settings.getCC(SensorChannel::BREATH), DinScheduler::PRIORITY_HIGHEST};
+  next.dinPriorityCount = count;
   
-  return constrain(output, 0.0, 1.0);
+  publishedSettings.write(next);
 }
 
-void sendMidi(){
-  sensors.update();
+// Runs in the control interrupt, which can preempt publishControlSettings(),
+// so a copy caught mid-write waits for the next tick
+void updateControlSettings() {
+  ControlSettings latest;
+  if (!publishedSettings.tryRead(latest) || latest.revision == controlSettings.revision) {
+    return;
+  }
+  controlSettings = latest;
   
-  // Get calibrated sensor values
-  float breath = constrain(sensors.getBreathNormalized() * settings.getCalBreath(), 0, 1);
-  float expression = constrain(sensors.getExpressionNormalized() * settings.getCalExp(), 0, 1);
-  float pinch = constrain(sensors.getPinchNormalized() * settings.getCalPinch(), 0, 1);
-  float tilt = constrain(sensors.getGyroX() * settings.getCalTilt(), 0, 1);
-  float nod = constrain(sensors.getGyroY() * settings.getCalNod(), 0, 1);
-  
-  // Apply curve, floor, and ceiling settings
-  breath = applyCurve(breath, settings.getBreathCurve(), settings.getBreathFloor(), settings.getBreathCeiling());
-  expression = applyCurve(expression, settings.getExpCurve(), settings.getExpFloor(), settings.getExpCeiling());
-  pinch = applyCurve(pinch, settings.getPinchCurve(), settings.getPinchFloor(), settings.getPinchCeiling());
-  tilt = applyCurve(tilt, settings.getTiltCurve(), settings.getTiltFloor(), settings.getTiltCeiling());
-  nod = applyCurve(nod, settings.getNodCurve(), settings.getNodFloor(), settings.getNodCeiling());
-    
-  uint8_t breathCC = breath * 127;
-  uint8_t expressionCC = expression * 127;
-  uint8_t pinchCC = pinch * 127;
-  uint8_t tiltCC = tilt * 127;
-  uint8_t nodCC = nod * 127;
-
-  if (settings.getUsbMidiEnabled()) {
-    usbMIDI.sendControlChange(settings.getBreathCC(), breathCC, settings.getMidiChannel());
-    usbMIDI.sendControlChange(settings.getExpCC(), expressionCC, settings.getMidiChannel());
-    usbMIDI.sendControlChange(settings.getPinchCC(), pinchCC, settings.getMidiChannel());
-    usbMIDI.sendControlChange(settings.getTiltCC(), tiltCC, settings.getMidiChannel());
-    usbMIDI.sendControlChange(settings.getNodCC(), nodCC, settings.getMidiChannel());
+  dinOut.resetControlPriorities();
+  for (uint8_t i = 0; i < controlSettings.dinPriorityCount; i++) {
+    dinOut.setControlPriority(controlSettings.dinPriorities[i].control, controlSettings.dinPriorities[i].priority);
   }
+}
 
-  if (settings.getHwMidiEnabled()) {
-    hwMIDI.sendControlChange(settings.getBreathCC(), breathCC, settings.getMidiChannel());
-    hwMIDI.sendControlChange(settings.getExpCC(), expressionCC, settings.getMidiChannel());
-    hwMIDI.sendControlChange(settings.getPinchCC(), pinchCC, settings.getMidiChannel());
-    hwMIDI.sendControlChange(settings.getTiltCC(), tiltCC, settings.getMidiChannel());
-    hwMIDI.sendControlChange(settings.getNodCC(), nodCC, settings.getMidiChannel());
+// IMU fields the active routes need: tilt, nod and twist read the gyro,
+// the orientation angles need the whole fusion input
+void updateImuRequest() {
+  uint16_t mask = responses.getMatrix().getSourceMask();
+  uint8_t fields = 0;
+  if (mask & (1 << (uint8_t)ModSource::TILT | 1 << (uint8_t)ModSource::NOD | 1 << (uint8_t)ModSource::TWIST)) {
+    fields |= IMU_GYRO;
+  }
+  if (mask & (1 << (uint8_t)ModSource::ROLL | 1 << (uint8_t)ModSource::PITCH | 1 << (uint8_t)ModSource::YAW)) {
+    fields |= IMU_ACCEL | IMU_GYRO | IMU_MAG;
   }
+  sensors.requestImuFields(ImuConsumer::MIDI_OUTPUT, fields);
 }
 
-void loop() {
+// Send one evaluated route; 14-bit values are reduced for 7-bit messages
+void sendOutput(MidiPort port, uint8_t channel, const ModOutput& out) {
+  switch (out.destination) {
+    case ModDestination::CC:
+      ccOut.send(port, channel, out.number, out.value >> 7);
+      break;
+    case ModDestination::CC_14BIT:
+      if (out.number < 32) {
+        ccOut.sendHighRes(port, channel, out.number, out.value);
+      } else {
+        ccOut.send(port, channel, out.number, out.value >> 7);
+      }
+      break;
+    case ModDestination::NRPN:
+      ccOut.sendNrpn(port, channel, out.number, out.value);
+      break;
+    case ModDestination::PITCH_BEND:
+      ccOut.sendPitchBend(port, channel, out.value);
+      break;
+    case ModDestination::CHANNEL_PRESSURE:
+      ccOut.sendPressure(port, channel, out.value >> 7);
+      break;
+    default:
+      break;
+  }
+}
+
+// Rebuild the matrix slots only when a setting changed. Runs in loop():
+// the control interrupt keeps using the previous tables until the swap.
+void applySettings(){
+  if (settings.getRevision() != matrixRevision) {
+    matrixRevision = settings.getRevision();
+    responses.update();
+    updateImuRequest();
+    publishControlSettings();
+  }
+}
+
+// Runs in the control interrupt; everything it calls is bounded. Both ports
+// only queue here: DIN drains as its wire budget allows, USB from loop().
+void sendMidi(){
+  updateControlSettings();
+  SensorSnapshot frame = sensors.getSnapshot();
+  
+  uint32_t cycles = profiler.start();
+  float sources[(uint8_t)ModSource::COUNT];
+  SignalChain::readSources(frame, sources);
+  
+  // Calibration, floor, ceiling, curve and amount are precompiled per slot
+  ModOutput outputs[ModMatrix::SLOTS];
+  uint8_t count = responses.evaluate(sources, outputs);
+  profiler.stop(PROFILE_CURVES, cycles);
   
+#ifdef MIDI2_UMP_OUTPUT
+  usbOut.setTime(frame.timestamp); // JR timestamps carry the sensor frame time
+#endif
+  
+  // Only changed values go out; unchanged ones are counted as suppressed
+  ccOut.update(millis());
+  uint8_t channel = controlSettings.midiChannel;
+  
+  for (uint8_t p = 0; p < (uint8_t)MidiPort::COUNT; p++) {
+    MidiPort port = (MidiPort)p;
+    if (port == MidiPort::USB && !controlSettings.usbMidiEnabled) continue;
+    if (port == MidiPort::DIN && !controlSettings.hwMidiEnabled) continue;
+    
+    for (uint8_t i = 0; i < count; i++) {
+      cycles = profiler.start();
+      // Each message carries the acquisition time of the sample it came
+      // from: the analog block, or the IMU read for motion sources
+      uint32_t stamp = isImuSource(outputs[i].source) ? frame.imuCycles : frame.analogCycles;
+      usbOut.setStamp(stamp);
+      dinOut.setStamp(stamp);
+      sendOutput(port, channel, outputs[i]);
+      profiler.stop(PROFILE_MIDI_SEND, cycles);
+    }
+  }
+  
+  // Release queued DIN messages as the wire budget allows; never blocks
+  cycles = profiler.start();
+  dinOut.service(micros());
+  profiler.stop(PROFILE_DIN, cycles);
+}
+
+void controlTimerISR(){
+  NVIC_SET_PENDING(IRQ_SOFTWARE);
+}
+
+void controlISR(){
+  uint32_t start = micros();
+  uint32_t tickCycles = profiler.start();
+  uint32_t cycles = profiler.start();
+  sensors.update();
+  profiler.stop(PROFILE_SENSORS, cycles);
   sendMidi();
+  profiler.stop(PROFILE_CONTROL, tickCycles);
+  cadence.record(start, micros());
+}
+
+// Copy taken with the control interrupt held off, so it is never half updated
+LatencySummary readLatency(uint8_t port){
+  noInterrupts();
+  LatencySummary summary = portLatency[port].summarize();
+  interrupts();
+  return summary;
+}
+
+void resetLatency(){
+  noInterrupts();
+  for (uint8_t p = 0; p < (uint8_t)MidiPort::COUNT; p++) {
+    portLatency[p].reset();
+  }
+  dinOut.resetStats();
+  usbOut.resetDropped();
+  interrupts();
+}
+
+// Sections recorded in the control interrupt are copied with it held off
+SectionProfile readProfile(uint8_t section){
+  noInterrupts();
+  SectionProfile profile = profiler.getProfile(section);
+  interrupts();
+  return profile;
+}
 
-  buttonUp.update();
-  buttonDown.update();
-  buttonLeft.update();
-  buttonRight.update();
+void resetProfile(){
+  noInterrupts();
+  profiler.reset();
+  interrupts();
+}
 
-  display.update();
+// 'c' prints the control cadence, 'r' resets it. Navigate the menus
+// in between to check that drawing does not disturb the MIDI rate.
+// 'l' prints sensor-to-MIDI latency per port and the DIN queue, 'L' resets them.
+// 'p' prints the cycle profile, 'P' resets it.
+// 'm' prints messages sent and suppressed per port, 'M' resets the counts.
+// 'i' prints IMU acquisition errors.
+// 't' prints background task overruns and lateness, 'T' resets them.
+void serviceSerial(){
+  while (Serial.available() > 0) {
+    char command = Serial.read();
+    if (command == 'c') {
+      CadenceStats stats = cadence.getStats();
+      Serial.printf("control: %lu ticks, interval %lu-%lu us (period %lu), %lu late, max run %lu us\n",
+                    stats.ticks, stats.minIntervalUs, stats.maxIntervalUs, cadence.getPeriod(),
+                    stats.lateTicks, stats.maxRunUs);
+    } else if (command == 'r') {
+      cadence.requestReset();
+      Serial.println("control: cadence reset");
+    } else if (command == 'l') {
+      for (uint8_t p = 0; p < (uint8_t)MidiPort::COUNT; p++) {
+        LatencySummary latency = readLatency(p);
+        Serial.printf("latency %s: %lu messages, min %lu, mean %lu, p99 %lu, max %lu us\n",
+                      p == (uint8_t)MidiPort::USB ? "USB" : "DIN", latency.count,
+                      latency.minUs, latency.meanUs, latency.p99Us, latency.maxUs);
+      }
+      // Queueing in front of the DIN wire, part of the DIN figures above
+      noInterrupts();
+      uint32_t replaced = dinOut.getReplaced();
+      uint32_t dropped = dinOut.getDropped();
+      uint32_t worstWait = dinOut.getWorstLatencyUs();
+      uint32_t saved = dinOut.getBytesSaved();
+      interrupts();
+      Serial.printf("din queue: %lu replaced, %lu dropped, worst wait %lu us, %lu status bytes saved\n",
+                    replaced, dropped, worstWait, saved);
+      Serial.printf("usb queue: %lu dropped\n", usbOut.getDropped());
+    } else if (command == 'L') {
+      resetLatency();
+      Serial.println("latency: reset");
+    } else if (command == 'p') {
+      uint32_t cyclesPerUs = F_CPU_ACTUAL / 1000000;
+      for (uint8_t i = 0; i < profiler.getSectionCount(); i++) {
+        SectionProfile profile = readProfile(i);
+        Serial.printf("profile %-10s %lu runs, mean %lu, worst %lu, peak %lu cycles (%lu us), %lu overruns\n",
+                      profile.name, profile.runs, profile.meanCycles, profile.worstCycles,
+                      profile.peakCycles, profile.peakCycles / cyclesPerUs, profile.overruns);
+      }
+    } else if (command == 'P') {
+      resetProfile();
+      Serial.println("profile: reset");
+    } else if (command == 'm') {
+      for (uint8_t p = 0; p < (uint8_t)MidiPort::COUNT; p++) {
+        noInterrupts();
+        uint32_t requested = ccOut.getRequested((MidiPort)p);
+        uint32_t sent = ccOut.getSent((MidiPort)p);
+        interrupts();
+        Serial.printf("transmit %s: %lu requested, %lu sent, %lu suppressed\n",
+                      p == (uint8_t)MidiPort::USB ? "USB" : "DIN", requested, sent, requested - sent);
+      }
+    } else if (command == 'M') {
+      noInterrupts();
+      ccOut.resetCounters();
+      interrupts();
+      Serial.println("transmit: reset");
+    } else if (command == 'i') {
+      static const char* const modes[] = {"polled", "FIFO", "async"};
+      Serial.printf("imu: %s mode, fields 0x%02x, %lu FIFO overflows, %lu bus errors, %lu resets, %lu skipped reads\n",
+                    modes[(uint8_t)sensors.getImuMode()], sensors.getImuFields(),
+                    sensors.getImuFifoOverflows(), sensors.getImuBusErrors(),
+                    sensors.getImuBusResets(), sensors.getImuSkippedReads());
+    } else if (command == 't') {
+      // Same context as the tasks, so no locking
+      for (uint8_t i = 0; i < scheduler.getTaskCount(); i++) {
+        const TaskScheduler::TaskStats& stats = scheduler.getStats(i);
+        Serial.printf("task %-8s %lu runs, %lu missed deadlines, %lu skipped, max late %lu us, max run %lu us\n",
+                      taskNames[i], stats.runs, stats.deadlineMisses, stats.skippedReleases,
+                      stats.maxLatencyUs, stats.maxRunUs);
+      }
+    } else if (command == 'T') {
+      scheduler.resetStats();
+      Serial.println("tasks: reset");
+    }
+  }
+}
 
-  delay(10);
+void loop() {
+  // Background work only; one task per pass, so loop() returns often enough for yield()
+  scheduler.runOnce();
 }
@@ -0,0 +1,174 @@
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include "AnalogBlock.h"
+#include "CicDecimator.h"
+
+// Stands in for the timer interrupt and the ADC: every tick reads one
+// sample of each input and stamps completed blocks, as AnalogSampler does.
+struct MockAdc {
+    uint32_t tick = 0;
+
+    uint16_t breath() const { return tick % 4096; }
+    uint16_t pinch() const { return 1000 + tick % 7; }
+    uint16_t expression() const { return 4095 - tick % 4096; }
+
+    void sample(AnalogBlockQueue& queue) {
+        if (queue.add(breath(), pinch(), expression())) {
+            queue.commit(tick * 100, tick * 60000);
+        }
+        tick++;
+    }
+};
+
+static AnalogBlockQueue queue;
+
+void setUp() {
+    queue.clear();
+}
+
+void tearDown() {
+}
+
+void test_blocks_complete_every_length_samples() {
+    MockAdc adc;
+    AnalogBlock block;
+
+    for (uint8_t i = 0; i < AnalogBlock::LENGTH - 1; i++) {
+        adc.sample(queue);
+    }
+    TEST_ASSERT_FALSE(queue.pop(block)); // no partial block is visible
+
+    adc.sample(queue);
+    TEST_ASSERT_TRUE(queue.pop(block));
+    for (uint8_t i = 0; i < AnalogBlock::LENGTH; i++) {
+        TEST_ASSERT_EQUAL_UINT16(i, block.breath[i]);
+        TEST_ASSERT_EQUAL_UINT16(1000 + i % 7, block.pinch[i]);
+        TEST_ASSERT_EQUAL_UINT16(4095 - i, block.expression[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32((AnalogBlock::LENGTH - 1) * 100, block.timestamp);
+    TEST_ASSERT_EQUAL_UINT32((AnalogBlock::LENGTH - 1) * 60000, block.cycles);
+    TEST_ASSERT_FALSE(queue.pop(block));
+}
+
+void test_blocks_arrive_in_order() {
+    MockAdc adc;
+    AnalogBlock block;
+
+    for (uint32_t i = 0; i < 3 * AnalogBlock::LENGTH; i++) {
+        adc.sample(queue);
+    }
+    for (uint8_t b = 0; b < 3; b++) {
+        TEST_ASSERT_TRUE(queue.pop(block));
+        TEST_ASSERT_EQUAL_UINT16(b * AnalogBlock::LENGTH, block.breath[0]);
+    }
+    TEST_ASSERT_FALSE(queue.pop(block));
+}
+
+void test_full_ring_drops_and_counts_samples() {
+    MockAdc adc;
+    AnalogBlock block;
+
+    // The ring keeps one slot free
+    const uint32_t capacity = AnalogBlockQueue::RING_BLOCKS - 1;
+    for (uint32_t i = 0; i < capacity * AnalogBlock::LENGTH; i++) {
+        adc.sample(queue);
+    }
+
+    uint32_t overruns = queue.getOverruns();
+    for (uint8_t i = 0; i < 5; i++) {
+        adc.sample(queue);
+    }
+    TEST_ASSERT_EQUAL_UINT32(overruns + 5, queue.getOverruns());
+
+    // Once the consumer catches up, the next block starts on a fresh sample
+    TEST_ASSERT_TRUE(queue.pop(block));
+    uint32_t resume = adc.tick;
+    for (uint8_t i = 0; i < AnalogBlock::LENGTH; i++) {
+        adc.sample(queue);
+    }
+    for (uint32_t i = 0; i < capacity; i++) {
+        TEST_ASSERT_TRUE(queue.pop(block));
+    }
+    TEST_ASSERT_EQUAL_UINT16(resume % 4096, block.breath[0]);
+    TEST_ASSERT_EQUAL_UINT32(overruns + 5, queue.getOverruns());
+}
+
+void test_clear_drops_partial_block() {
+    MockAdc adc;
+    AnalogBlock block;
+
+    for (uint8_t i = 0; i < AnalogBlock::LENGTH + 3; i++) {
+        adc.sample(queue);
+    }
+    queue.clear();
+    TEST_ASSERT_FALSE(queue.pop(block));
+
+    // A full block after the clear, not the 3 leftover samples plus 13
+    uint32_t start = adc.tick;
+    for (uint8_t i = 0; i < AnalogBlock::LENGTH - 1; i++) {
+        adc.sample(queue);
+    }
+    TEST_ASSERT_FALSE(queue.pop(block));
+    adc.sample(queue);
+    TEST_ASSERT_TRUE(queue.pop(block));
+    TEST_ASSERT_EQUAL_UINT16(start % 4096, block.breath[0]);
+}
+
+void test_consumer_reduces_blocks() {
+    AnalogBlock block;
+    CicDecimator breath;
+    breath.reset(2000);
+
+    // Constant inputs: breath keeps its 16x scale, the others average
+    for (uint8_t i = 0; i < AnalogBlock::LENGTH; i++) {
+        queue.add(2000, 100 + i, 3000 + (i & 1));
+    }
+    queue.commit(0, 0);
+    TEST_ASSERT_TRUE(queue.pop(block));
+
+    TEST_ASSERT_EQUAL_UINT16(2000 * CicDecimator::RATIO, breath.process(block.breath));
+    TEST_ASSERT_EQUAL_UINT16(107, AnalogBlock::average(block.pinch)); // 107.5 truncated
+    TEST_ASSERT_EQUAL_UINT16(3000, AnalogBlock::average(block.expression));
+}
+
+// Reports the cost of producing and consuming one block; not asserted,
+// host timing says little about the Teensy beyond relative changes
+void test_benchmark_block_path() {
+    const uint32_t BLOCKS = 200000;
+    MockAdc adc;
+    AnalogBlock block;
+    CicDecimator breath;
+    uint32_t checksum = 0;
+    uint32_t overruns = queue.getOverruns();
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t b = 0; b < BLOCKS; b++) {
+        for (uint8_t i = 0; i < AnalogBlock::LENGTH; i++) {
+            adc.sample(queue);
+        }
+        while (queue.pop(block)) {
+            checksum += breath.process(block.breath);
+            checksum += AnalogBlock::average(block.pinch);
+            checksum += AnalogBlock::average(block.expression);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / BLOCKS;
+    char message[80];
+    snprintf(message, sizeof(message), "%.1f ns per block (checksum %lu)", ns, (unsigned long)checksum);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT32(overruns, queue.getOverruns());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_blocks_complete_every_length_samples);
+    RUN_TEST(test_blocks_arrive_in_order);
+    RUN_TEST(test_full_ring_drops_and_counts_samples);
+    RUN_TEST(test_clear_drops_partial_block);
+    RUN_TEST(test_consumer_reduces_blocks);
+    RUN_TEST(test_benchmark_block_path);
+    return UNITY_END();
+}
@@ -0,0 +1,290 @@
+#include <unity.h>
+#include <string.h>
+#include "AsyncI2C.h"
+
+// Fake LPI2C master with one register-file slave. step() executes one
+// queued command the way the hardware would and then raises the port
+// interrupt if it is enabled and has a reason to fire.
+class FakeI2CPort : public I2CPort {
+public:
+    static const uint8_t FIFO_DEPTH = 2; // smaller than a transfer, so feeding takes several interrupts
+
+    uint8_t slaveAddress = 0x68;
+    uint8_t registers[256];
+    bool stalled = false;      // bus hangs: commands are never executed
+    uint32_t injectFlags = 0;  // raised on the next step()
+
+    uint16_t sent[16];         // every command executed, in order
+    uint8_t sentCount = 0;
+    uint8_t aborts = 0;
+    bool interruptsOn = false;
+    bool wantSpace = false;
+
+    void (*isr)() = nullptr;
+
+    FakeI2CPort() {
+        for (int i = 0; i < 256; i++) {
+            registers[i] = (uint8_t)(i * 7 + 1);
+        }
+    }
+
+    void attach(void (*handler)()) override { isr = handler; }
+    uint8_t commandSpace() override { return FIFO_DEPTH - commandCount; }
+    void pushCommand(uint16_t command) override {
+        TEST_ASSERT_TRUE_MESSAGE(commandCount < FIFO_DEPTH, "command FIFO overfilled");
+        commands[commandCount++] = command;
+    }
+    bool popData(uint8_t& data) override {
+        if (rxHead == rxCount) {
+            return false;
+        }
+        data = rx[rxHead++];
+        return true;
+    }
+    uint32_t status() override { return flags; }
+    void clearStatus(uint32_t clear) override { flags &= ~clear; }
+    void enableInterrupts(bool enabled, bool wantCommandSpace) override {
+        interruptsOn = enabled;
+        wantSpace = wantCommandSpace;
+    }
+    void abort() override {
+        aborts++;
+        commandCount = 0;
+        rxHead = rxCount = 0;
+        addressed = false;
+    }
+
+    // One bus event; returns false when there was nothing to do
+    bool step() {
+        bool worked = false;
+        flags |= injectFlags;
+        injectFlags = 0;
+
+        if (!stalled && commandCount > 0 && !(flags & I2C_STATUS_ERRORS)) {
+            execute(commands[0]);
+            memmove(commands, commands + 1, (commandCount - 1) * sizeof(commands[0]));
+            commandCount--;
+            worked = true;
+        }
+        if (interruptsOn && isr && (flags || rxHead < rxCount || (wantSpace && commandSpace() > 0))) {
+            isr();
+            worked = true;
+        }
+        return worked;
+    }
+
+private:
+    void execute(uint16_t command) {
+        sent[sentCount++] = command;
+        uint8_t data = command & 0xFF;
+
+        switch (command & 0x700) {
+            case I2C_CMD_START:
+                addressed = (data >> 1) == slaveAddress;
+                reading = data & 1;
+                if (!addressed) {
+                    flags |= I2C_STATUS_NAK;
+                }
+                break;
+            case I2C_CMD_TRANSMIT:
+                pointer = data;
+                break;
+            case I2C_CMD_RECEIVE:
+                for (uint16_t i = 0; i <= data; i++) {
+                    rx[rxCount++] = registers[pointer++];
+                }
+                break;
+            case I2C_CMD_STOP:
+                flags |= I2C_STATUS_STOP;
+                addressed = false;
+                break;
+        }
+    }
+
+    uint16_t commands[FIFO_DEPTH];
+    uint8_t commandCount = 0;
+    uint8_t rx[64];
+    uint8_t rxHead = 0;
+    uint8_t rxCount = 0;
+    uint32_t flags = 0;
+    bool addressed = false;
+    bool reading = false;
+    uint8_t pointer = 0;
+};
+
+static FakeI2CPort* port;
+static AsyncI2C* bus;
+
+void setUp() {
+    port = new FakeI2CPort();
+    bus = new AsyncI2C(*port);
+    bus->begin();
+}
+
+void tearDown() {
+    delete bus;
+    delete port;
+}
+
+// Runs the bus until it goes quiet
+static void runBus() {
+    for (int i = 0; i < 100 && port->step(); i++) {
+    }
+}
+
+void test_read_completes_with_expected_commands() {
+    uint8_t buffer[6] = {};
+    TEST_ASSERT_TRUE(bus->startRead(0x68, 0x2D, buffer, 6, 1000, 2000));
+    TEST_ASSERT_EQUAL(I2CState::BUSY, bus->poll(1000));
+
+    runBus();
+    TEST_ASSERT_EQUAL(I2CState::DONE, bus->poll(1100));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(&port->registers[0x2D], buffer, 6);
+
+    const uint16_t expected[] = {
+        I2C_CMD_START | 0x68 << 1,
+        I2C_CMD_TRANSMIT | 0x2D,
+        I2C_CMD_START | 0x68 << 1 | 1,
+        I2C_CMD_RECEIVE | 5,
+        I2C_CMD_STOP
+    };
+    TEST_ASSERT_EQUAL(5, port->sentCount);
+    for (uint8_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_HEX16(expected[i], port->sent[i]);
+    }
+    TEST_ASSERT_FALSE(port->interruptsOn);
+    TEST_ASSERT_EQUAL(I2CError::NONE, bus->getLastError());
+
+    bus->acknowledge();
+    TEST_ASSERT_TRUE(bus->isIdle());
+}
+
+void test_start_is_rejected_while_busy_or_empty() {
+    uint8_t buffer[4];
+    TEST_ASSERT_FALSE(bus->startRead(0x68, 0x00, buffer, 0, 0, 2000));
+    TEST_ASSERT_TRUE(bus->startRead(0x68, 0x00, buffer, 4, 0, 2000));
+    TEST_ASSERT_FALSE(bus->startRead(0x68, 0x10, buffer, 4, 0, 2000));
+
+    // Still rejected once done, until the result is acknowledged
+    runBus();
+    TEST_ASSERT_EQUAL(I2CState::DONE, bus->poll(10));
+    TEST_ASSERT_FALSE(bus->startRead(0x68, 0x10, buffer, 4, 10, 2000));
+    bus->acknowledge();
+    TEST_ASSERT_TRUE(bus->startRead(0x68, 0x10, buffer, 4, 10, 2000));
+}
+
+void test_nak_fails_aborts_and_recovers() {
+    uint8_t buffer[4] = {};
+    port->slaveAddress = 0x69; // nobody answers 0x68
+    TEST_ASSERT_TRUE(bus->startRead(0x68, 0x00, buffer, 4, 0, 2000));
+    runBus();
+
+    TEST_ASSERT_EQUAL(I2CState::FAILED, bus->poll(50));
+    TEST_ASSERT_EQUAL(I2CError::NAK, bus->getLastError());
+    TEST_ASSERT_EQUAL_UINT32(1, bus->getErrorCount());
+    TEST_ASSERT_EQUAL(1, port->aborts);
+    TEST_ASSERT_FALSE(port->interruptsOn);
+
+    // The next transfer starts clean once the slave answers again
+    bus->acknowledge();
+    port->slaveAddress = 0x68;
+    port->clearStatus(I2C_STATUS_ERRORS); // the driver clears flags on start too
+    TEST_ASSERT_TRUE(bus->startRead(0x68, 0x00, buffer, 4, 100, 2000));
+    runBus();
+    TEST_ASSERT_EQUAL(I2CState::DONE, bus->poll(150));
+    TEST_ASSERT_EQUAL(I2CError::NONE, bus->getLastError());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(&port->registers[0], buffer, 4);
+}
+
+void test_bus_errors_map_to_their_codes() {
+    const uint32_t flags[] = {I2C_STATUS_ARB_LOST, I2C_STATUS_FIFO_ERROR, I2C_STATUS_PIN_LOW};
+    const I2CError errors[] = {I2CError::ARBITRATION_LOST, I2CError::FIFO_ERROR, I2CError::PIN_LOW_TIMEOUT};
+    uint8_t buffer[2];
+
+    for (uint8_t i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(bus->startRead(0x68, 0x00, buffer, 2, 0, 2000));
+        port->injectFlags = flags[i];
+        runBus();
+        TEST_ASSERT_EQUAL(I2CState::FAILED, bus->poll(10));
+        TEST_ASSERT_EQUAL(errors[i], bus->getLastError());
+        bus->acknowledge();
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, bus->getErrorCount());
+    TEST_ASSERT_EQUAL(3, port->aborts);
+}
+
+void test_stalled_bus_times_out() {
+    uint8_t buffer[4];
+    port->stalled = true;
+    TEST_ASSERT_TRUE(bus->startRead(0x68, 0x00, buffer, 4, 5000, 2000));
+    runBus();
+
+    TEST_ASSERT_EQUAL(I2CState::BUSY, bus->poll(6000));
+    TEST_ASSERT_EQUAL(I2CState::BUSY, bus->poll(7000)); // exactly the timeout is still in time
+    TEST_ASSERT_EQUAL(I2CState::FAILED, bus->poll(7001));
+    TEST_ASSERT_EQUAL(I2CError::TIMEOUT, bus->getLastError());
+    TEST_ASSERT_FALSE(port->interruptsOn);
+    TEST_ASSERT_EQUAL(1, port->aborts);
+}
+
+void test_timeout_survives_clock_wraparound() {
+    uint8_t buffer[4];
+    port->stalled = true;
+    TEST_ASSERT_TRUE(bus->startRead(0x68, 0x00, buffer, 4, 0xFFFFFF00, 2000));
+
+    TEST_ASSERT_EQUAL(I2CState::BUSY, bus->poll(0x00000100)); // 512 us later
+    TEST_ASSERT_EQUAL(I2CState::FAILED, bus->poll(0x00000800));
+}
+
+void test_short_read_before_stop_is_a_fifo_error() {
+    uint8_t buffer[4];
+    TEST_ASSERT_TRUE(bus->startRead(0x68, 0x00, buffer, 4, 0, 2000));
+
+    // Feed the first commands, then pretend STOP went out with no data
+    port->step();
+    port->injectFlags = I2C_STATUS_STOP;
+    port->stalled = true;
+    runBus();
+
+    TEST_ASSERT_EQUAL(I2CState::FAILED, bus->poll(10));
+    TEST_ASSERT_EQUAL(I2CError::FIFO_ERROR, bus->getLastError());
+}
+
+// The port interrupt preempts the caller, so a transfer can finish
+// between poll() returning BUSY and acknowledge(); the result must wait
+// for the next poll() instead of being thrown away
+void test_completion_between_poll_and_acknowledge_is_kept() {
+    uint8_t buffer[6] = {};
+    TEST_ASSERT_TRUE(bus->startRead(0x68, 0x2D, buffer, 6, 0, 2000));
+    TEST_ASSERT_EQUAL(I2CState::BUSY, bus->poll(10));
+
+    runBus(); // completes here
+    bus->acknowledge();
+    TEST_ASSERT_FALSE(bus->isIdle());
+    TEST_ASSERT_EQUAL(I2CState::DONE, bus->poll(20));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(&port->registers[0x2D], buffer, 6);
+    bus->acknowledge();
+    TEST_ASSERT_TRUE(bus->isIdle());
+
+    // Same for a failure, so the error reaches the caller's retry logic
+    port->slaveAddress = 0x69;
+    TEST_ASSERT_TRUE(bus->startRead(0x68, 0x00, buffer, 4, 100, 2000));
+    TEST_ASSERT_EQUAL(I2CState::BUSY, bus->poll(110));
+    runBus();
+    bus->acknowledge();
+    TEST_ASSERT_EQUAL(I2CState::FAILED, bus->poll(120));
+    TEST_ASSERT_EQUAL(I2CError::NAK, bus->getLastError());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_read_completes_with_expected_commands);
+    RUN_TEST(test_start_is_rejected_while_busy_or_empty);
+    RUN_TEST(test_nak_fails_aborts_and_recovers);
+    RUN_TEST(test_bus_errors_map_to_their_codes);
+    RUN_TEST(test_stalled_bus_times_out);
+    RUN_TEST(test_timeout_survives_clock_wraparound);
+    RUN_TEST(test_short_read_before_stop_is_a_fifo_error);
+    RUN_TEST(test_completion_between_poll_and_acknowledge_is_kept);
+    return UNITY_END();
+}
@@ -0,0 +1,212 @@
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "CicDecimator.h"
+
+static const uint8_t R = CicDecimator::RATIO;
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+static void fill(uint16_t* block, uint16_t value) {
+    for (uint8_t i = 0; i < R; i++) {
+        block[i] = value;
+    }
+}
+
+// Gain of the decimator for a sine at the given frequency, in cycles per
+// output sample, measured by correlating a long run of outputs
+static double measureGain(double cyclesPerOutput) {
+    const int OUTPUTS = 4096;
+    const double amplitude = 1000;
+    double w = 2 * M_PI * cyclesPerOutput;
+    CicDecimator decimator;
+    decimator.reset(2048);
+
+    uint16_t block[R];
+    double s = 0;
+    double c = 0;
+    long n = 0;
+    for (int k = 0; k < OUTPUTS + 8; k++) {
+        for (uint8_t i = 0; i < R; i++, n++) {
+            block[i] = (uint16_t)lround(2048 + amplitude * sin(w * n / R));
+        }
+        uint16_t out = decimator.process(block);
+        if (k >= 8) {
+            s += out * sin(w * k);
+            c += out * cos(w * k);
+        }
+    }
+    return 2 * hypot(s, c) / OUTPUTS / (amplitude * R);
+}
+
+void test_dc_gain_is_ratio() {
+    CicDecimator decimator;
+    uint16_t block[R];
+    const uint16_t levels[] = {0, 1, 1000, 2048, 4094, 4095};
+
+    for (uint16_t level : levels) {
+        decimator.reset(level);
+        fill(block, level);
+        TEST_ASSERT_EQUAL_UINT16(level * R, decimator.process(block));
+    }
+    TEST_ASSERT_EQUAL_UINT16(CicDecimator::FULL_SCALE, 4095 * R);
+}
+
+void test_reset_has_no_startup_ramp() {
+    CicDecimator decimator;
+    uint16_t block[R];
+    decimator.reset(3000);
+    fill(block, 3000);
+
+    for (uint8_t i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL_UINT16(3000 * R, decimator.process(block));
+    }
+}
+
+void test_step_response_settles_within_five_outputs() {
+    CicDecimator decimator;
+    uint16_t block[R];
+    decimator.reset(1000);
+    fill(block, 3000);
+
+    uint16_t out[8];
+    for (uint8_t i = 0; i < 8; i++) {
+        out[i] = decimator.process(block);
+    }
+
+    // Moves on the first output, overshoots by about 1% from the droop
+    // compensation, then holds the new level exactly
+    TEST_ASSERT_NOT_EQUAL(1000 * R, out[0]);
+    for (uint8_t i = 0; i < 8; i++) {
+        TEST_ASSERT_LESS_OR_EQUAL(3000 * R * 102 / 100, out[i]);
+    }
+    for (uint8_t i = 4; i < 8; i++) {
+        TEST_ASSERT_EQUAL_UINT16(3000 * R, out[i]);
+    }
+}
+
+void test_full_scale_step_is_clamped() {
+    CicDecimator decimator;
+    uint16_t block[R];
+    decimator.reset(0);
+    fill(block, 4095);
+
+    for (uint8_t i = 0; i < 8; i++) {
+        TEST_ASSERT_LESS_OR_EQUAL(CicDecimator::FULL_SCALE, decimator.process(block));
+    }
+    TEST_ASSERT_EQUAL_UINT16(CicDecimator::FULL_SCALE, decimator.process(block));
+
+    // And back down without wrapping below zero
+    fill(block, 0);
+    for (uint8_t i = 0; i < 8; i++) {
+        TEST_ASSERT_LESS_OR_EQUAL(CicDecimator::FULL_SCALE, decimator.process(block));
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, decimator.process(block));
+}
+
+void test_passband_is_flat_where_breath_lives() {
+    // Up to a tenth of the output rate (62 Hz at 10 kHz sampling)
+    TEST_ASSERT_FLOAT_WITHIN(0.005, 1.0, measureGain(0.01));
+    TEST_ASSERT_FLOAT_WITHIN(0.005, 1.0, measureGain(0.05));
+    TEST_ASSERT_FLOAT_WITHIN(0.005, 1.0, measureGain(0.1));
+}
+
+void test_rejects_tones_that_alias_into_the_passband() {
+    // Input tones just off the output rate and its harmonic fold down to
+    // 0.02 cycles per output; the CIC nulls sit on those frequencies
+    TEST_ASSERT_LESS_THAN_FLOAT(0.01, measureGain(1.02));
+    TEST_ASSERT_LESS_THAN_FLOAT(0.01, measureGain(2.02));
+}
+
+// ENOB of the decimated output for a dithered 12-bit sine, from a
+// least-squares sine fit; oversampling by 16 should add about 2 bits
+void test_enob_exceeds_adc_resolution() {
+    const int OUTPUTS = 4096;
+    const double w = 2 * M_PI * 37 / OUTPUTS; // whole cycles in the record
+    static double y[OUTPUTS];
+
+    CicDecimator decimator;
+    decimator.reset(2048);
+    srand(1);
+    uint16_t block[R];
+    long n = 0;
+    for (int k = 0; k < OUTPUTS + 8; k++) {
+        for (uint8_t i = 0; i < R; i++, n++) {
+            double dither = rand() / (double)RAND_MAX - 0.5;
+            block[i] = (uint16_t)lround(2048 + 1800 * sin(w * n / R) + dither);
+        }
+        uint16_t out = decimator.process(block);
+        if (k >= 8) {
+            y[k - 8] = out;
+        }
+    }
+
+    // Fit a sin + b cos + c; the basis is orthogonal over whole cycles
+    double a = 0, b = 0, c = 0;
+    for (int k = 0; k < OUTPUTS; k++) {
+        a += y[k] * sin(w * k);
+        b += y[k] * cos(w * k);
+        c += y[k];
+    }
+    a *= 2.0 / OUTPUTS;
+    b *= 2.0 / OUTPUTS;
+    c /= OUTPUTS;
+
+    double error = 0;
+    for (int k = 0; k < OUTPUTS; k++) {
+        double r = y[k] - (a * sin(w * k) + b * cos(w * k) + c);
+        error += r * r;
+    }
+    error = sqrt(error / OUTPUTS);
+    double enob = log2(CicDecimator::FULL_SCALE / (error * sqrt(12.0)));
+    double amplitude = hypot(a, b);
+
+    char message[80];
+    snprintf(message, sizeof(message), "ENOB %.2f bits, amplitude %.1f", enob, amplitude);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_GREATER_THAN_FLOAT(13.0, enob);
+    TEST_ASSERT_FLOAT_WITHIN(1800 * R * 0.005, 1800 * R, amplitude);
+}
+
+// Reports the cost per output sample; not asserted, host timing only
+// shows relative changes
+void test_benchmark_per_output_sample() {
+    const uint32_t OUTPUTS = 1000000;
+    CicDecimator decimator;
+    uint16_t block[R];
+    for (uint8_t i = 0; i < R; i++) {
+        block[i] = i * 200;
+    }
+
+    uint32_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t k = 0; k < OUTPUTS; k++) {
+        block[k % R] ^= 1;
+        checksum += decimator.process(block);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / OUTPUTS;
+    char message[80];
+    snprintf(message, sizeof(message), "%.1f ns per output sample (checksum %lu)", ns, (unsigned long)checksum);
+    TEST_MESSAGE(message);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_dc_gain_is_ratio);
+    RUN_TEST(test_reset_has_no_startup_ramp);
+    RUN_TEST(test_step_response_settles_within_five_outputs);
+    RUN_TEST(test_full_scale_step_is_clamped);
+    RUN_TEST(test_passband_is_flat_where_breath_lives);
+    RUN_TEST(test_rejects_tones_that_alias_into_the_passband);
+    RUN_TEST(test_enob_exceeds_adc_resolution);
+    RUN_TEST(test_benchmark_per_output_sample);
+    return UNITY_END();
+}
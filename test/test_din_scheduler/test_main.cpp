@@ -0,0 +1,130 @@
+#include <unity.h>
+#include <stdio.h>
+#include "DinScheduler.h"
+
+// Stands in for Serial5: plenty of TX buffer, so only the scheduler's own
+// budget limits the rate, and every byte written is recorded
+static uint8_t wire[1 << 16];
+static uint32_t wireBytes;
+static int uartSpace;
+
+static int fakeSpace() {
+    return uartSpace;
+}
+
+static void fakeWrite(const uint8_t* data, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        wire[wireBytes++ % sizeof(wire)] = data[i];
+    }
+}
+
+static const uint32_t SERVICE_PERIOD_US = 1000; // control rate
+static const uint32_t BURST_ALLOWANCE = 12;     // one whole NRPN group
+
+void setUp() {
+    wireBytes = 0;
+    uartSpace = 64;
+}
+
+void tearDown() {
+}
+
+// Runs the scheduler at the control rate for the given time, calling
+// produce(tick) before every service; returns the bytes written
+template <typename Produce>
+static uint32_t run(DinScheduler& din, uint32_t durationUs, Produce produce) {
+    uint32_t start = wireBytes;
+    for (uint32_t t = 0; t <= durationUs; t += SERVICE_PERIOD_US) {
+        produce(t / SERVICE_PERIOD_US);
+        din.service(t);
+    }
+    return wireBytes - start;
+}
+
+// Two parameters alternating, so every group carries its 99/98 select
+// and the full 6/38 data entry
+void test_sustained_nrpn_stays_within_wire_rate() {
+    DinScheduler din(fakeSpace, fakeWrite);
+    const uint32_t SECONDS = 10;
+    uint32_t bytes = run(din, SECONDS * 1000000, [&](uint32_t tick) {
+        din.nrpn(tick & 1 ? 300 : 301, (tick * 37) & 0x3FFF, 1);
+    });
+
+    char message[80];
+    snprintf(message, sizeof(message), "%lu bytes in %lu s, budget %lu B/s",
+             (unsigned long)bytes, (unsigned long)SECONDS, (unsigned long)DinScheduler::WIRE_BYTES_PER_SECOND);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_OR_EQUAL(DinScheduler::WIRE_BYTES_PER_SECOND * SECONDS + BURST_ALLOWANCE, bytes);
+    // And the wire is actually used, not starved waiting for a full budget
+    TEST_ASSERT_TRUE(bytes >= DinScheduler::WIRE_BYTES_PER_SECOND * SECONDS * 9 / 10);
+}
+
+// Every one-second window is within budget, not just the average
+void test_nrpn_rate_holds_in_every_second() {
+    DinScheduler din(fakeSpace, fakeWrite);
+    for (uint32_t second = 0; second < 5; second++) {
+        uint32_t bytes = 0;
+        for (uint32_t t = 0; t < 1000000; t += SERVICE_PERIOD_US) {
+            uint32_t tick = t / SERVICE_PERIOD_US;
+            din.nrpn(tick & 1 ? 300 : 301, tick & 0x3FFF, 1);
+            uint32_t before = wireBytes;
+            din.service(second * 1000000 + t);
+            bytes += wireBytes - before;
+        }
+        TEST_ASSERT_LESS_OR_EQUAL(DinScheduler::WIRE_BYTES_PER_SECOND + BURST_ALLOWANCE, bytes);
+    }
+}
+
+void test_sustained_cc_stays_within_wire_rate() {
+    DinScheduler din(fakeSpace, fakeWrite);
+    const uint32_t SECONDS = 10;
+    uint32_t bytes = run(din, SECONDS * 1000000, [&](uint32_t tick) {
+        for (uint8_t cc = 1; cc <= 5; cc++) {
+            din.controlChange(cc, (tick + cc) & 0x7F, (tick & 1) + 1);
+        }
+    });
+    TEST_ASSERT_LESS_OR_EQUAL(DinScheduler::WIRE_BYTES_PER_SECOND * SECONDS + BURST_ALLOWANCE, bytes);
+    TEST_ASSERT_TRUE(bytes >= DinScheduler::WIRE_BYTES_PER_SECOND * SECONDS * 9 / 10);
+}
+
+// A group goes out whole, select and data entry back to back, once the
+// budget covers all of it
+void test_nrpn_group_is_written_unbroken() {
+    DinScheduler din(fakeSpace, fakeWrite);
+    din.nrpn(300, 0x1234, 2);
+    din.service(0);
+    TEST_ASSERT_EQUAL(0, wireBytes); // starts with a two-message burst only
+    din.service(2000);
+
+    const uint8_t expected[] = {0xB1, 99, 300 >> 7, 98, 300 & 0x7F, 6, 0x1234 >> 7, 38, 0x1234 & 0x7F};
+    TEST_ASSERT_EQUAL(sizeof(expected), wireBytes);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, wire, sizeof(expected));
+}
+
+// A newer value replaces the one still waiting instead of queueing behind it
+void test_latest_value_replaces_waiting_one() {
+    DinScheduler din(fakeSpace, fakeWrite);
+    uartSpace = 0;
+    din.controlChange(7, 10, 1);
+    din.controlChange(7, 20, 1);
+    din.controlChange(7, 30, 1);
+    din.service(0);
+    TEST_ASSERT_EQUAL(1, din.pending());
+    TEST_ASSERT_EQUAL_UINT32(2, din.getReplaced());
+
+    uartSpace = 64;
+    din.service(1000);
+    const uint8_t expected[] = {0xB0, 7, 30};
+    TEST_ASSERT_EQUAL(sizeof(expected), wireBytes);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, wire, sizeof(expected));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_sustained_nrpn_stays_within_wire_rate);
+    RUN_TEST(test_nrpn_rate_holds_in_every_second);
+    RUN_TEST(test_sustained_cc_stays_within_wire_rate);
+    RUN_TEST(test_nrpn_group_is_written_unbroken);
+    RUN_TEST(test_latest_value_replaces_waiting_one);
+    return UNITY_END();
+}
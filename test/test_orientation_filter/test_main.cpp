@@ -0,0 +1,167 @@
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "OrientationFilter.h"
+
+static const float DEG = 0.0174532925f;
+
+// Gravity and a field pointing north with 60 degrees of dip, in the earth
+// frame (x north, z up), as the filter expects them
+static const float EARTH_MAG_X = 0.5f;
+static const float EARTH_MAG_Z = -0.866f;
+
+// Earth-frame vector seen from a sensor at the given ZYX attitude
+struct Attitude {
+    float r[3][3]; // sensor to earth
+
+    Attitude(float rollDeg, float pitchDeg, float yawDeg) {
+        float cr = cosf(rollDeg * DEG), sr = sinf(rollDeg * DEG);
+        float cp = cosf(pitchDeg * DEG), sp = sinf(pitchDeg * DEG);
+        float cy = cosf(yawDeg * DEG), sy = sinf(yawDeg * DEG);
+        r[0][0] = cy * cp; r[0][1] = cy * sp * sr - sy * cr; r[0][2] = cy * sp * cr + sy * sr;
+        r[1][0] = sy * cp; r[1][1] = sy * sp * sr + cy * cr; r[1][2] = sy * sp * cr - cy * sr;
+        r[2][0] = -sp;     r[2][1] = cp * sr;                r[2][2] = cp * cr;
+    }
+
+    void toSensor(float ex, float ey, float ez, float& x, float& y, float& z) const {
+        x = r[0][0] * ex + r[1][0] * ey + r[2][0] * ez;
+        y = r[0][1] * ex + r[1][1] * ey + r[2][1] * ez;
+        z = r[0][2] * ex + r[1][2] * ey + r[2][2] * ez;
+    }
+};
+
+static float norm(const OrientationFilter& filter) {
+    return sqrtf(filter.getQ0() * filter.getQ0() + filter.getQ1() * filter.getQ1()
+               + filter.getQ2() * filter.getQ2() + filter.getQ3() * filter.getQ3());
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_reset_takes_roll_and_pitch_from_gravity() {
+    Attitude attitude(30, -20, 0);
+    float ax, ay, az;
+    attitude.toSensor(0, 0, 1, ax, ay, az);
+
+    OrientationFilter filter;
+    filter.reset(ax, ay, az);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, filter.getRoll());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -20.0f, filter.getPitch());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, filter.getYaw());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, norm(filter));
+}
+
+// Held still at a known attitude, accel and mag pull the estimate there
+// from level; at the default gain that takes well under 30 seconds
+void test_converges_to_static_accel_mag_attitude() {
+    Attitude attitude(25, 15, 40);
+    float ax, ay, az, mx, my, mz;
+    attitude.toSensor(0, 0, 1, ax, ay, az);
+    attitude.toSensor(EARTH_MAG_X, 0, EARTH_MAG_Z, mx, my, mz);
+
+    OrientationFilter filter;
+    for (int i = 0; i < 3000; i++) {
+        filter.update(0, 0, 0, ax, ay, az, mx * 50, my * 50, mz * 50, 0.01f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 25.0f, filter.getRoll());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 15.0f, filter.getPitch());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 40.0f, filter.getYaw());
+}
+
+// Without mag, a level sensor converges in roll and pitch only
+void test_converges_without_mag() {
+    Attitude attitude(-35, 10, 0);
+    float ax, ay, az;
+    attitude.toSensor(0, 0, 1, ax, ay, az);
+
+    OrientationFilter filter;
+    for (int i = 0; i < 3000; i++) {
+        filter.update(0, 0, 0, ax, ay, az, 0, 0, 0, 0.01f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, -35.0f, filter.getRoll());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 10.0f, filter.getPitch());
+}
+
+// With no correction the quaternion follows the gyro exactly: 45 deg/s
+// for two seconds is a 90 degree turn on each axis in turn
+void test_gyro_only_integration_of_known_rate() {
+    OrientationFilter filter;
+    filter.setBeta(0);
+    for (int i = 0; i < 2000; i++) {
+        filter.update(0, 0, 45.0f, 0, 0, 0, 0, 0, 0, 0.001f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 90.0f, filter.getYaw());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, filter.getRoll());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, filter.getPitch());
+
+    OrientationFilter rolling;
+    rolling.setBeta(0);
+    for (int i = 0; i < 1000; i++) {
+        rolling.update(-60.0f, 0, 0, 0, 0, 0, 0, 0, 0, 0.001f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, -60.0f, rolling.getRoll());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, rolling.getYaw());
+}
+
+// Every step renormalises, however rough the input
+void test_quaternion_stays_normalised() {
+    OrientationFilter filter;
+    srand(1);
+    float worst = 0;
+    for (int i = 0; i < 20000; i++) {
+        float g[3], a[3], m[3];
+        for (int k = 0; k < 3; k++) {
+            g[k] = (rand() % 4001 - 2000) * 1.0f;
+            a[k] = (rand() % 33 - 16) * 1.0f;
+            m[k] = (rand() % 201 - 100) * 1.0f;
+        }
+        float dt = (1 + rand() % 100) * 0.001f;
+        if (i % 2) {
+            filter.update(g[0], g[1], g[2], a[0], a[1], a[2], m[0], m[1], m[2], dt);
+        } else {
+            filter.updateIMU(g[0], g[1], g[2], a[0], a[1], a[2], dt);
+        }
+        worst = fmaxf(worst, fabsf(norm(filter) - 1.0f));
+    }
+    TEST_ASSERT_FALSE(isnan(filter.getQ0()));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, worst);
+}
+
+// Reports the cost of a 9-axis step; not asserted, host timing only
+// shows relative changes
+void test_benchmark_per_update() {
+    const uint32_t UPDATES = 1000000;
+    Attitude attitude(10, 5, 20);
+    float ax, ay, az, mx, my, mz;
+    attitude.toSensor(0, 0, 1, ax, ay, az);
+    attitude.toSensor(EARTH_MAG_X, 0, EARTH_MAG_Z, mx, my, mz);
+
+    OrientationFilter filter;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t k = 0; k < UPDATES; k++) {
+        float wobble = (k & 15) * 0.5f;
+        filter.update(wobble, -wobble, 1.0f, ax, ay, az, mx, my, mz, 0.001f);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / UPDATES;
+    char message[80];
+    snprintf(message, sizeof(message), "%.1f ns per update (yaw %.2f)", ns, filter.getYaw());
+    TEST_MESSAGE(message);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reset_takes_roll_and_pitch_from_gravity);
+    RUN_TEST(test_converges_to_static_accel_mag_attitude);
+    RUN_TEST(test_converges_without_mag);
+    RUN_TEST(test_gyro_only_integration_of_known_rate);
+    RUN_TEST(test_quaternion_stays_normalised);
+    RUN_TEST(test_benchmark_per_update);
+    return UNITY_END();
+}
@@ -0,0 +1,170 @@
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include "ResponseMap.h"
+#include "SignalChain.h"
+
+// Output steps of the 14-bit table
+static const double FULL_SCALE = ResponseMap::OUTPUT_MAX;
+
+struct Trim {
+    float floor;
+    float ceiling;
+};
+
+static const Trim TRIMS[] = {{0.0f, 1.0f}, {0.1f, 0.9f}, {0.25f, 0.6f}};
+
+// Rising, with a flat step and a steep stretch
+static const CurvePoints USER_POINTS = {{0, 10, 40, 40, 120, 200, 240, 255}};
+
+static ResponseMap table;
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// Largest difference between the table and the float curve over every
+// 12-bit input code
+static double worstLookupError(int curve, const Trim& trim, const CurvePoints* points) {
+    table.build(1.0f, curve, trim.floor, trim.ceiling, points);
+    double worst = 0;
+    for (uint16_t code = 0; code < ResponseMap::SIZE; code++) {
+        double direct = ResponseMap::evaluate(code / (float)(ResponseMap::SIZE - 1), curve,
+                                              trim.floor, trim.ceiling, points) * FULL_SCALE;
+        worst = fmax(worst, fabs(table.lookup(code) - direct));
+    }
+    return worst;
+}
+
+// Each entry is the float curve rounded to 14 bits, so no code is off by
+// more than half a step, for every preset and a user curve
+void test_lookup_matches_direct_curve_at_every_code() {
+    double worst = 0;
+    for (int curve = 1; curve <= SignalChain::CURVE_COUNT; curve++) {
+        for (const Trim& trim : TRIMS) {
+            worst = fmax(worst, worstLookupError(curve, trim, nullptr));
+        }
+    }
+    for (const Trim& trim : TRIMS) {
+        worst = fmax(worst, worstLookupError(USER_CURVE_FIRST, trim, &USER_POINTS));
+    }
+
+    char message[80];
+    snprintf(message, sizeof(message), "worst table error %.3f of 16383", worst);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(worst <= 0.5 + 1e-3);
+}
+
+// With calibration 1 an ADC code lands exactly on a table entry
+void test_map_of_adc_codes_equals_lookup() {
+    for (int curve = 1; curve <= SignalChain::CURVE_COUNT; curve++) {
+        table.build(1.0f, curve, 0.1f, 0.9f);
+        for (uint16_t code = 0; code < ResponseMap::SIZE; code++) {
+            TEST_ASSERT_EQUAL_UINT16(table.lookup(code), table.map(code / (float)(ResponseMap::SIZE - 1)));
+        }
+    }
+}
+
+// Calibration moves inputs between entries, which map() interpolates.
+// On curves with a bounded slope that stays within 4 of 16383, a thirtieth
+// of a 7-bit CC step; the error is largest at the floor and ceiling kinks.
+// The convex presets (3, 6, 8) are steep just above the floor and are
+// left out here.
+void test_map_interpolates_calibrated_input_within_four_steps() {
+    static const int smoothCurves[] = {1, 2, 4, 5, 7, 9, 10, USER_CURVE_FIRST};
+    static const float calibrations[] = {0.8f, 1.25f, 1.5f, 2.0f};
+
+    double worst = 0;
+    for (int curve : smoothCurves) {
+        const CurvePoints* points = curve == USER_CURVE_FIRST ? &USER_POINTS : nullptr;
+        for (float calibration : calibrations) {
+            for (const Trim& trim : TRIMS) {
+                table.build(calibration, curve, trim.floor, trim.ceiling, points);
+                for (uint16_t code = 0; code < ResponseMap::SIZE; code++) {
+                    float input = code / (float)(ResponseMap::SIZE - 1);
+                    double direct = ResponseMap::evaluate(input * calibration, curve,
+                                                          trim.floor, trim.ceiling, points) * FULL_SCALE;
+                    worst = fmax(worst, fabs(table.map(input) - direct));
+                }
+            }
+        }
+    }
+
+    char message[80];
+    snprintf(message, sizeof(message), "worst interpolated error %.2f of 16383", worst);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(worst <= 4.0);
+}
+
+// build() reports whether it did any work, so unchanged settings are free
+void test_build_skips_unchanged_parameters() {
+    TEST_ASSERT_TRUE(table.build(1.2f, 5, 0.1f, 0.9f));
+    TEST_ASSERT_FALSE(table.build(1.2f, 5, 0.1f, 0.9f));
+    TEST_ASSERT_TRUE(table.build(1.2f, 6, 0.1f, 0.9f));
+    // Points only matter to user curves
+    TEST_ASSERT_FALSE(table.build(1.2f, 6, 0.1f, 0.9f, &USER_POINTS));
+}
+
+// Stored points are only trusted when they rise, as the editor keeps them
+void test_user_curve_points_validity() {
+    TEST_ASSERT_TRUE(SplineCurve::linear().isValid());
+    TEST_ASSERT_TRUE(USER_POINTS.isValid());
+
+    const CurvePoints erased = {{255, 255, 255, 255, 255, 255, 255, 255}};
+    const CurvePoints falling = {{0, 40, 30, 60, 90, 120, 200, 255}};
+    const CurvePoints inverted = {{255, 200, 160, 120, 90, 60, 30, 0}};
+    TEST_ASSERT_FALSE(erased.isValid());
+    TEST_ASSERT_FALSE(falling.isValid());
+    TEST_ASSERT_FALSE(inverted.isValid());
+}
+
+// ns per sample for the table and for the float chain it replaces
+static void benchmark(int curve) {
+    const uint32_t SAMPLES = 4000000;
+    const float calibration = 1.1f;
+    table.build(calibration, curve, 0.05f, 0.95f);
+    const auto direct = SignalChain::makeChain(SignalChain::response(calibration, curve, 0.05f, 0.95f),
+                                               SignalChain::Quantize<14>());
+
+    // volatile step so neither loop is folded away
+    volatile float step = 1.0f / SAMPLES;
+    uint32_t lutChecksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t k = 0; k < SAMPLES; k++) {
+        lutChecksum += table.map(k * step);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    uint32_t floatChecksum = 0;
+    for (uint32_t k = 0; k < SAMPLES; k++) {
+        floatChecksum += direct(k * step);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double lutNs = std::chrono::duration<double, std::nano>(middle - start).count() / SAMPLES;
+    double floatNs = std::chrono::duration<double, std::nano>(end - middle).count() / SAMPLES;
+    char message[100];
+    snprintf(message, sizeof(message), "curve %d: LUT %.2f ns, float %.2f ns per sample (checksums %lu, %lu)",
+             curve, lutNs, floatNs, (unsigned long)lutChecksum, (unsigned long)floatChecksum);
+    TEST_MESSAGE(message);
+}
+
+// Not asserted, host timing only shows relative changes. Curve 5 goes
+// through powf on the float path, curve 4 is polynomial only.
+void test_benchmark_lut_against_float_path() {
+    benchmark(5);
+    benchmark(4);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_lookup_matches_direct_curve_at_every_code);
+    RUN_TEST(test_map_of_adc_codes_equals_lookup);
+    RUN_TEST(test_map_interpolates_calibrated_input_within_four_steps);
+    RUN_TEST(test_build_skips_unchanged_parameters);
+    RUN_TEST(test_user_curve_points_validity);
+    RUN_TEST(test_benchmark_lut_against_float_path);
+    return UNITY_END();
+}
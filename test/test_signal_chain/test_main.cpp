@@ -0,0 +1,193 @@
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include "ModMatrix.h"
+#include "SignalChain.h"
+
+// Stands in for SensorSnapshot: every source reads the same value, so one
+// sweep drives whichever source a slot is routed from
+struct Frame {
+    float value;
+    float gyroX, gyroY;
+
+    float breathNormalized() const { return value; }
+    float pinchNormalized() const { return value; }
+    float expressionNormalized() const { return value; }
+    float twistNormalized() const { return value; }
+    float rollNormalized() const { return value; }
+    float pitchNormalized() const { return value; }
+    float yawNormalized() const { return value; }
+};
+
+// Rising, with a flat step and a steep stretch
+static const CurvePoints USER_POINTS = {{0, 10, 40, 40, 120, 200, 240, 255}};
+
+struct Trim {
+    uint8_t floor;
+    uint8_t ceiling;
+};
+
+static const Trim TRIMS[] = {{0, 100}, {10, 90}, {25, 60}, {70, 30}};
+
+// Powers of two scale floats exactly, so both paths see the same
+// calibrated input and the table lands on its own entries
+static const float CALIBRATIONS[] = {1.0f, 0.5f, 2.0f};
+
+static ModMatrix matrix;
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// Runs one response through both instantiations over every input code:
+// the MIDI path (readSources, then the slot's ResponseMap in ModMatrix)
+// and the curve preview (readSource, Calibrate and Clamp, then response()),
+// quantized to the same 14 bits. Returns the number of codes that differ.
+static uint32_t compare(ModSource source, uint8_t curve, const Trim& trim, float calibration) {
+    ModSlot slot;
+    slot.source = source;
+    slot.destination = ModDestination::CC_14BIT;
+    slot.curve = curve;
+    slot.floor = trim.floor;
+    slot.ceiling = trim.ceiling;
+    matrix.setUserCurve(0, USER_POINTS);
+    matrix.setSlot(0, slot, calibration);
+
+    SplineCurve spline;
+    spline.setPoints(USER_POINTS);
+    const auto input = SignalChain::makeChain(SignalChain::Calibrate{calibration}, SignalChain::Clamp());
+    const auto preview = SignalChain::response(curve, trim.floor / 100.0f, trim.ceiling / 100.0f, &spline);
+    const SignalChain::Quantize<14> quantize;
+
+    uint32_t mismatches = 0;
+    for (uint16_t code = 0; code < ResponseMap::SIZE; code++) {
+        Frame frame;
+        frame.value = code / (float)(ResponseMap::SIZE - 1) / calibration;
+        frame.gyroX = frame.gyroY = frame.value;
+
+        float sources[(uint8_t)ModSource::COUNT];
+        SignalChain::readSources(frame, sources);
+        ModOutput outputs[ModMatrix::SLOTS];
+        matrix.evaluate(sources, outputs);
+
+        uint16_t shown = quantize(preview(input(SignalChain::readSource(frame, source))));
+        if (outputs[0].value != shown) {
+            if (mismatches == 0) {
+                char message[100];
+                snprintf(message, sizeof(message), "curve %d, code %u: MIDI %u, preview %u",
+                         curve, code, outputs[0].value, shown);
+                TEST_MESSAGE(message);
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+// Every preset and a user curve, each trim including floor above ceiling
+void test_midi_path_equals_preview_for_every_curve() {
+    for (uint8_t curve = 1; curve <= USER_CURVE_FIRST; curve++) {
+        for (const Trim& trim : TRIMS) {
+            for (float calibration : CALIBRATIONS) {
+                TEST_ASSERT_EQUAL_UINT32(0, compare(ModSource::BREATH, curve, trim, calibration));
+            }
+        }
+    }
+}
+
+// readSources() and readSource() pick the same field for each source
+void test_midi_path_equals_preview_for_every_source() {
+    for (uint8_t source = 0; source < (uint8_t)ModSource::COUNT; source++) {
+        TEST_ASSERT_EQUAL_UINT32(0, compare((ModSource)source, 4, TRIMS[1], 1.0f));
+    }
+}
+
+// Each output names its route's source, which picks its latency stamp
+void test_outputs_carry_their_source() {
+    for (uint8_t source = 0; source < (uint8_t)ModSource::COUNT; source++) {
+        ModSlot slot;
+        slot.source = (ModSource)source;
+        slot.destination = ModDestination::CC;
+        matrix.setSlot(0, slot, 1.0f);
+
+        float sources[(uint8_t)ModSource::COUNT] = {};
+        ModOutput outputs[ModMatrix::SLOTS];
+        TEST_ASSERT_EQUAL_UINT8(1, matrix.evaluate(sources, outputs));
+        TEST_ASSERT_EQUAL_UINT8(source, (uint8_t)outputs[0].source);
+        TEST_ASSERT_EQUAL(source >= (uint8_t)ModSource::TILT, isImuSource(outputs[0].source));
+    }
+}
+
+// The preset path written out by hand, as it was before the chain: the
+// reference the composed stages have to match in output and speed
+static uint16_t handWritten(float x, float calibration, const SignalChain::CurveShape& shape,
+                            float floor, float ceiling) {
+    x *= calibration;
+    if (!(x > 0.0f)) x = 0.0f;
+    if (x > 1.0f) x = 1.0f;
+
+    if (x < floor) x = 0.0f;
+    else if (x > ceiling || ceiling <= floor) x = 1.0f;
+    else x = (x - floor) / (ceiling - floor);
+
+    float y = shape.exponent == 1.0f ? x : powf(x, shape.exponent);
+    if (shape.blend > 0.0f) {
+        float s = y * y * (3.0f - 2.0f * y);
+        if (shape.blend <= 1.0f) {
+            y = y + (s - y) * shape.blend;
+        } else {
+            y = s + (s * s * (3.0f - 2.0f * s) - s) * (shape.blend - 1.0f);
+        }
+    }
+    return (uint16_t)(y * 16383 + 0.5f);
+}
+
+// ns per sample for the composed chain and the hand-written equivalent
+static void benchmark(int curve) {
+    const uint32_t SAMPLES = 4000000;
+    const float calibration = 1.1f;
+    const auto chain = SignalChain::makeChain(SignalChain::response(calibration, curve, 0.05f, 0.95f),
+                                              SignalChain::Quantize<14>());
+    const SignalChain::CurveShape shape = SignalChain::CURVE_SHAPES[curve - 1];
+
+    // volatile step so neither loop is folded away
+    volatile float step = 1.0f / SAMPLES;
+    uint32_t chainChecksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t k = 0; k < SAMPLES; k++) {
+        chainChecksum += chain(k * step);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    uint32_t handChecksum = 0;
+    for (uint32_t k = 0; k < SAMPLES; k++) {
+        handChecksum += handWritten(k * step, calibration, shape, 0.05f, 0.95f);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double chainNs = std::chrono::duration<double, std::nano>(middle - start).count() / SAMPLES;
+    double handNs = std::chrono::duration<double, std::nano>(end - middle).count() / SAMPLES;
+    char message[100];
+    snprintf(message, sizeof(message), "curve %d: chain %.2f ns, hand-written %.2f ns per sample",
+             curve, chainNs, handNs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT32(handChecksum, chainChecksum);
+}
+
+// Timings are reported, not asserted; the outputs must match exactly
+void test_chain_benchmark() {
+    benchmark(1);  // linear
+    benchmark(5);  // powf
+    benchmark(10); // smoothstep twice
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_midi_path_equals_preview_for_every_curve);
+    RUN_TEST(test_midi_path_equals_preview_for_every_source);
+    RUN_TEST(test_outputs_carry_their_source);
+    RUN_TEST(test_chain_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,174 @@
+#include <unity.h>
+#include "TaskScheduler.h"
+
+// Virtual clock: time only moves when a test or a task moves it
+static uint32_t now;
+
+static uint32_t fakeClock() {
+    return now;
+}
+
+// Each task records that it ran and then takes its run time off the clock
+static char order[16];
+static uint8_t orderCount;
+static uint32_t runTime[3];
+
+static void ran(char name, uint8_t task) {
+    if (orderCount < sizeof(order) - 1) order[orderCount++] = name;
+    order[orderCount] = 0;
+    now += runTime[task];
+}
+
+static void taskA() { ran('A', 0); }
+static void taskB() { ran('B', 1); }
+static void taskC() { ran('C', 2); }
+
+void setUp() {
+    now = 0;
+    orderCount = 0;
+    order[0] = 0;
+    for (uint32_t& time : runTime) time = 0;
+}
+
+void tearDown() {
+}
+
+// All released together, the earliest deadline goes first whatever the
+// order the tasks were added in
+void test_released_tasks_run_earliest_deadline_first() {
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask(taskA, 10000);
+    scheduler.addTask(taskB, 10000, 2000);
+    scheduler.addTask(taskC, 20000, 5000);
+
+    while (scheduler.runOnce()) {
+    }
+    TEST_ASSERT_EQUAL_STRING("BCA", order);
+}
+
+// A later release with a tighter deadline goes ahead of a waiting task
+// whose deadline is further out
+void test_deadline_not_period_decides_order() {
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask(taskA, 10000);       // due by 10000
+    now = 3000;
+    scheduler.addTask(taskB, 10000, 1000); // released at 3000, due by 4000
+
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_STRING("BA", order);
+}
+
+// Nothing runs before its release, and idleTime() says how long to wait
+void test_nothing_runs_before_release() {
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask(taskA, 1000);
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_FALSE(scheduler.runOnce());
+
+    now = 400;
+    TEST_ASSERT_EQUAL_UINT32(600, scheduler.idleTime());
+    TEST_ASSERT_FALSE(scheduler.runOnce());
+
+    now = 1000;
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.idleTime());
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_UINT32(2, scheduler.getStats(0).runs);
+}
+
+// A task that finishes after release + deadline counts as a miss, one
+// that finishes in time does not
+void test_overrun_counts_deadline_miss() {
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask(taskA, 10000, 500);
+    runTime[0] = 400;
+    scheduler.runOnce();
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(0).deadlineMisses);
+    TEST_ASSERT_EQUAL_UINT32(400, scheduler.getStats(0).maxRunUs);
+
+    now = 10000;
+    runTime[0] = 600;
+    scheduler.runOnce();
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.getStats(0).deadlineMisses);
+    TEST_ASSERT_EQUAL_UINT32(600, scheduler.getStats(0).maxRunUs);
+}
+
+// A long task delays the next one; the wait shows as its latency and the
+// delayed task misses its own deadline
+void test_blocking_task_shows_as_latency_of_others() {
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask(taskA, 10000, 1000);
+    scheduler.addTask(taskB, 10000, 2000);
+    runTime[0] = 2500;
+
+    scheduler.runOnce();
+    scheduler.runOnce();
+    TEST_ASSERT_EQUAL_STRING("AB", order);
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.getStats(0).deadlineMisses);
+    TEST_ASSERT_EQUAL_UINT32(2500, scheduler.getStats(1).maxLatencyUs);
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.getStats(1).deadlineMisses);
+}
+
+// Falling whole periods behind skips those releases and keeps the grid,
+// instead of running back to back to catch up
+void test_overrun_past_period_skips_releases() {
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask(taskA, 1000);
+    runTime[0] = 3500;
+    scheduler.runOnce(); // ends at 3500, releases at 1000, 2000 and 3000 are gone
+    TEST_ASSERT_EQUAL_UINT32(2, scheduler.getStats(0).skippedReleases);
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.getStats(0).deadlineMisses);
+
+    // Next release is 3000, on the original grid
+    runTime[0] = 0;
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_UINT32(500, scheduler.getStats(0).maxLatencyUs);
+    TEST_ASSERT_FALSE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_UINT32(500, scheduler.idleTime());
+}
+
+// Order and lateness stay right when the microsecond clock wraps
+void test_clock_wraparound() {
+    now = 0xFFFFFC00; // 1024 us before the wrap
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask(taskA, 2000);
+    scheduler.addTask(taskB, 2000, 1500);
+    scheduler.runOnce();
+    scheduler.runOnce();
+
+    now += 2100; // past the wrap, both released again and 100 us late
+    scheduler.runOnce();
+    scheduler.runOnce();
+    TEST_ASSERT_EQUAL_STRING("BABA", order);
+    TEST_ASSERT_EQUAL_UINT32(100, scheduler.getStats(0).maxLatencyUs);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(0).deadlineMisses);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(0).skippedReleases);
+}
+
+void test_reset_clears_stats() {
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask(taskA, 1000, 100);
+    runTime[0] = 2500;
+    scheduler.runOnce();
+    scheduler.resetStats();
+
+    const TaskScheduler::TaskStats& stats = scheduler.getStats(0);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.deadlineMisses);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.skippedReleases);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.maxLatencyUs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.maxRunUs);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_released_tasks_run_earliest_deadline_first);
+    RUN_TEST(test_deadline_not_period_decides_order);
+    RUN_TEST(test_nothing_runs_before_release);
+    RUN_TEST(test_overrun_counts_deadline_miss);
+    RUN_TEST(test_blocking_task_shows_as_latency_of_others);
+    RUN_TEST(test_overrun_past_period_skips_releases);
+    RUN_TEST(test_clock_wraparound);
+    RUN_TEST(test_reset_clears_stats);
+    return UNITY_END();
+}
@@ -0,0 +1,192 @@
+#include <unity.h>
+#include "UmpEncoder.h"
+#include "UmpSink.h"
+
+// Captures what UmpSink writes; every expected word below is worked out
+// by hand from the UMP format, not taken from the encoder
+static uint32_t written[8];
+static uint8_t writtenCount;
+static uint32_t handoffs;
+static uint32_t lastStamp;
+
+static void capture(const uint32_t* words, uint8_t count) {
+    for (uint8_t i = 0; i < count && writtenCount < 8; i++) {
+        written[writtenCount++] = words[i];
+    }
+}
+
+static void handoff(uint32_t stamp) {
+    handoffs++;
+    lastStamp = stamp;
+}
+
+void setUp() {
+    writtenCount = 0;
+    handoffs = 0;
+    lastStamp = 0;
+}
+
+void tearDown() {
+}
+
+// 0 stays 0, center goes to 0x80000000, full scale to all ones, and
+// above center the bits below the top one repeat into the new low bits
+void test_scale_up_min_center_max() {
+    TEST_ASSERT_EQUAL_HEX32(0x00000000, UmpEncoder::scaleUp(0, 7));
+    TEST_ASSERT_EQUAL_HEX32(0x02000000, UmpEncoder::scaleUp(1, 7));
+    TEST_ASSERT_EQUAL_HEX32(0x80000000, UmpEncoder::scaleUp(64, 7));
+    TEST_ASSERT_EQUAL_HEX32(0xC1041041, UmpEncoder::scaleUp(96, 7)); // 0b100000 repeated
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, UmpEncoder::scaleUp(127, 7));
+
+    TEST_ASSERT_EQUAL_HEX32(0x40000000, UmpEncoder::scaleUp(0x1000, 14));
+    TEST_ASSERT_EQUAL_HEX32(0x80000000, UmpEncoder::scaleUp(0x2000, 14));
+    TEST_ASSERT_EQUAL_HEX32(0xC0020010, UmpEncoder::scaleUp(0x3000, 14)); // low 13 bits repeated
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, UmpEncoder::scaleUp(0x3FFF, 14));
+
+    TEST_ASSERT_EQUAL_HEX32(0x3FFF, UmpEncoder::scaleDown(0xFFFFFFFF, 14));
+    TEST_ASSERT_EQUAL_HEX32(0x40, UmpEncoder::scaleDown(0x80000000, 7));
+}
+
+// Type 4, group, opcode B, channel - 1, then index and a 32-bit value
+void test_control_change_words() {
+    UmpSink sink(capture);
+    sink.setTimestamps(false);
+
+    sink.controlChange(2, 127, 1);
+    sink.flush();
+    TEST_ASSERT_EQUAL(2, writtenCount);
+    TEST_ASSERT_EQUAL_HEX32(0x40B00200, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, written[1]);
+
+    writtenCount = 0;
+    sink.controlChange(74, 64, 16);
+    sink.flush();
+    TEST_ASSERT_EQUAL_HEX32(0x40BF4A00, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x80000000, written[1]);
+}
+
+// The MSB/LSB pair collapses into one CC on the MSB number
+void test_high_res_control_is_one_packet() {
+    UmpSink sink(capture);
+    sink.setTimestamps(false);
+
+    sink.highResControl(1, 0x2000, 3);
+    sink.flush();
+    TEST_ASSERT_EQUAL(2, writtenCount);
+    TEST_ASSERT_EQUAL_HEX32(0x40B20100, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x80000000, written[1]);
+
+    writtenCount = 0;
+    sink.highResControl(7, 0x1000, 1);
+    sink.flush();
+    TEST_ASSERT_EQUAL_HEX32(0x40B00700, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x40000000, written[1]);
+}
+
+// Opcode 3, bank = NRPN MSB, index = NRPN LSB; no parameter selects
+void test_nrpn_is_assignable_controller() {
+    UmpSink sink(capture);
+    sink.setTimestamps(false);
+
+    sink.nrpn(0x81, 0x2000, 3);
+    sink.flush();
+    TEST_ASSERT_EQUAL(2, writtenCount);
+    TEST_ASSERT_EQUAL_HEX32(0x40320101, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x80000000, written[1]);
+
+    writtenCount = 0;
+    sink.nrpn(0x3FFF, 0x3FFF, 10);
+    sink.flush();
+    TEST_ASSERT_EQUAL_HEX32(0x40397F7F, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, written[1]);
+}
+
+void test_pitch_bend_and_pressure_words() {
+    UmpSink sink(capture);
+    sink.setTimestamps(false);
+
+    sink.pitchBend(8192, 1);
+    sink.flush();
+    sink.channelPressure(127, 2);
+    sink.flush();
+    TEST_ASSERT_EQUAL(4, writtenCount);
+    TEST_ASSERT_EQUAL_HEX32(0x40E00000, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x80000000, written[1]); // center stays exact
+    TEST_ASSERT_EQUAL_HEX32(0x40D10000, written[2]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, written[3]);
+}
+
+void test_group_goes_in_the_first_word() {
+    UmpSink sink(capture, 5);
+    sink.setTimestamps(false);
+
+    sink.controlChange(2, 0, 1);
+    sink.flush();
+    TEST_ASSERT_EQUAL_HEX32(0x45B00200, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x00000000, written[1]);
+}
+
+// Type 0, status 2, 16 bits of 1/31250 s ticks from the time last set
+void test_jr_timestamp_precedes_each_packet() {
+    UmpSink sink(capture);
+    sink.setTime(1000 * UmpEncoder::JR_TICK_US);
+
+    sink.controlChange(2, 127, 1);
+    sink.flush();
+    TEST_ASSERT_EQUAL(3, writtenCount);
+    TEST_ASSERT_EQUAL_HEX32(0x002003E8, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x40B00200, written[1]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, written[2]);
+
+    // The tick count wraps at 16 bits
+    writtenCount = 0;
+    sink.setTime((65536 + 5) * UmpEncoder::JR_TICK_US + 31);
+    sink.nrpn(0x81, 0, 1);
+    sink.flush();
+    TEST_ASSERT_EQUAL_HEX32(0x00200005, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x40300101, written[1]);
+}
+
+void test_midi1_control_change_in_ump() {
+    uint32_t words[2];
+    TEST_ASSERT_EQUAL(1, UmpEncoder::midi1ControlChange(words, 1, 2, 11, 100));
+    TEST_ASSERT_EQUAL_HEX32(0x21B10B64, words[0]);
+}
+
+// Nothing reaches the writer until flush(), which runs in loop()
+void test_packets_wait_for_flush() {
+    UmpSink sink(capture);
+    sink.controlChange(2, 127, 1);
+    TEST_ASSERT_EQUAL(0, writtenCount);
+    sink.flush();
+    TEST_ASSERT_EQUAL(3, writtenCount);
+}
+
+// Every packet hands off the stamp of the value it carries, when it is written
+void test_handoff_reports_the_stamp() {
+    UmpSink sink(capture);
+    sink.setHandoffFunction(handoff);
+    sink.setStamp(1234);
+    sink.controlChange(1, 1, 1);
+    sink.setStamp(5678);
+    sink.nrpn(5, 5, 1);
+    TEST_ASSERT_EQUAL_UINT32(0, handoffs);
+    sink.flush();
+    TEST_ASSERT_EQUAL_UINT32(2, handoffs);
+    TEST_ASSERT_EQUAL_UINT32(5678, lastStamp);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_scale_up_min_center_max);
+    RUN_TEST(test_control_change_words);
+    RUN_TEST(test_high_res_control_is_one_packet);
+    RUN_TEST(test_nrpn_is_assignable_controller);
+    RUN_TEST(test_pitch_bend_and_pressure_words);
+    RUN_TEST(test_group_goes_in_the_first_word);
+    RUN_TEST(test_jr_timestamp_precedes_each_packet);
+    RUN_TEST(test_midi1_control_change_in_ump);
+    RUN_TEST(test_packets_wait_for_flush);
+    RUN_TEST(test_handoff_reports_the_stamp);
+    return UNITY_END();
+}
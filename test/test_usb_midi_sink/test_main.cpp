@@ -0,0 +1,140 @@
+#include <unity.h>
+#include "UsbMidiSink.h"
+#include "CcTransmitter.h"
+
+// Stands in for usb_midi_write_packed(); expected packets are worked out
+// by hand from the USB MIDI 1.0 event packet layout
+static uint32_t written[1024];
+static uint16_t writtenCount;
+static uint32_t handoffs;
+static uint32_t lastStamp;
+
+static void capture(const uint32_t* words, uint8_t count) {
+    for (uint8_t i = 0; i < count && writtenCount < 1024; i++) {
+        written[writtenCount++] = words[i];
+    }
+}
+
+static void handoff(uint32_t stamp) {
+    handoffs++;
+    lastStamp = stamp;
+}
+
+void setUp() {
+    writtenCount = 0;
+    handoffs = 0;
+    lastStamp = 0;
+}
+
+void tearDown() {
+}
+
+// Code index number, status, data 1, data 2 from the low byte up
+void test_packets() {
+    UsbMidiSink sink(capture);
+    sink.controlChange(7, 100, 1);
+    sink.pitchBend(8192, 2);
+    sink.channelPressure(127, 16);
+    sink.highResControl(1, 0x1234, 3);
+    sink.flush();
+
+    TEST_ASSERT_EQUAL(5, writtenCount);
+    TEST_ASSERT_EQUAL_HEX32(0x6407B00B, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x4000E10E, written[1]);
+    TEST_ASSERT_EQUAL_HEX32(0x007FDF0D, written[2]);
+    TEST_ASSERT_EQUAL_HEX32(0x2401B20B, written[3]);
+    TEST_ASSERT_EQUAL_HEX32(0x3421B20B, written[4]);
+}
+
+// Nothing reaches the port until flush(), which then hands off each
+// message with the stamp it was sent with
+void test_messages_wait_for_flush() {
+    UsbMidiSink sink(capture);
+    sink.setHandoffFunction(handoff);
+    sink.setStamp(111);
+    sink.controlChange(1, 1, 1);
+    sink.setStamp(222);
+    sink.nrpn(5, 5, 1);
+    TEST_ASSERT_EQUAL(0, writtenCount);
+    TEST_ASSERT_EQUAL_UINT32(0, handoffs);
+
+    sink.flush();
+    TEST_ASSERT_EQUAL(5, writtenCount);
+    TEST_ASSERT_EQUAL_UINT32(2, handoffs);
+    TEST_ASSERT_EQUAL_UINT32(222, lastStamp);
+}
+
+// 99/98 only when the channel's parameter changes, or after a reset
+void test_nrpn_select_is_sent_when_needed() {
+    UsbMidiSink sink(capture);
+    sink.nrpn(300, 0x1234, 1);
+    sink.nrpn(300, 0x1235, 1);
+    sink.flush();
+    TEST_ASSERT_EQUAL(6, writtenCount);
+    TEST_ASSERT_EQUAL_HEX32(0x0263B00B, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x2C62B00B, written[1]);
+    TEST_ASSERT_EQUAL_HEX32(0x2406B00B, written[2]);
+    TEST_ASSERT_EQUAL_HEX32(0x3426B00B, written[3]);
+    TEST_ASSERT_EQUAL_HEX32(0x2406B00B, written[4]);
+    TEST_ASSERT_EQUAL_HEX32(0x3526B00B, written[5]);
+
+    writtenCount = 0;
+    sink.refresh();
+    sink.nrpn(300, 0x1234, 1);
+    sink.flush();
+    TEST_ASSERT_EQUAL(4, writtenCount);
+    TEST_ASSERT_EQUAL_HEX32(0x0263B00B, written[0]);
+}
+
+// A full queue drops and counts instead of waiting, and a dropped select
+// goes out again with the next value
+void test_full_queue_drops() {
+    UsbMidiSink sink(capture);
+    for (uint16_t i = 0; i < 200; i++) {
+        sink.controlChange(1, i & 0x7F, 1);
+    }
+    TEST_ASSERT_EQUAL_UINT32(200 - 127, sink.getDropped());
+
+    sink.nrpn(300, 1, 1); // select dropped with it
+    sink.flush();
+    TEST_ASSERT_EQUAL(127, writtenCount);
+
+    writtenCount = 0;
+    sink.nrpn(300, 2, 1);
+    sink.flush();
+    TEST_ASSERT_EQUAL(4, writtenCount);
+    TEST_ASSERT_EQUAL_HEX32(0x0263B00B, written[0]);
+}
+
+// Only the value goes out per refresh otherwise, so the refresh round
+// makes the USB side select the parameter again too
+void test_refresh_round_reselects_nrpn() {
+    UsbMidiSink usb(capture);
+    UsbMidiSink din(nullptr);
+    CcTransmitter transmitter(usb, din);
+    transmitter.setRefreshInterval(2000);
+    transmitter.update(0);
+
+    transmitter.sendNrpn(MidiPort::USB, 1, 44, 100);
+    transmitter.sendNrpn(MidiPort::USB, 1, 44, 200);
+    usb.flush();
+    TEST_ASSERT_EQUAL(6, writtenCount);
+
+    writtenCount = 0;
+    transmitter.update(2000);
+    transmitter.sendNrpn(MidiPort::USB, 1, 44, 200);
+    usb.flush();
+    TEST_ASSERT_EQUAL(4, writtenCount);
+    TEST_ASSERT_EQUAL_HEX32(0x0063B00B, written[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x2C62B00B, written[1]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_packets);
+    RUN_TEST(test_messages_wait_for_flush);
+    RUN_TEST(test_nrpn_select_is_sent_when_needed);
+    RUN_TEST(test_full_queue_drops);
+    RUN_TEST(test_refresh_round_reselects_nrpn);
+    return UNITY_END();
+}